@@ -1,11 +1,15 @@
 #ifndef ALGORITHM_H
 #define ALGORITHM_H
 
+#include <memory>
 #include <vector>
 #include <string>
 
 #include "Player.hpp"
 #include "Board.hpp"
+#include "MoveOrdering.hpp"
+#include "MovePicker.hpp"
+#include "TranspositionTable.hpp"
 
 /**
  * Header definition for class Algorithm. 
@@ -21,6 +25,8 @@
  *       We stop evaluating a possible move when at least one option is found to be worse than a previously examined move. 
  *       NOTE: It should return the SAME result as minimax, just "prunes" branches that will not affect the final outcome, 
  *             thus improving performance. 
+ *       Alpha-Beta can also run as Principal Variation Search, a negamax form that searches all but the first move 
+ *       of a node with a null window, see principalVariationSearch. 
  * 
  * Three evaluation functions will be used in conjunction with the two search algorithms. 
  * 
@@ -38,7 +44,7 @@ public:
     struct Result
     {
         int value;
-        Board::Move bestMove;
+        Board::PackedMove bestMove; // see Board::unpackMove for the full move
     };
 
     int minimaxExpandedNodes;  // how many nodes we expand
@@ -46,46 +52,159 @@ public:
     int absearchExpandedNodes; // how many nodes we expand
     int absearchLeafNodes;     // how many nodes we expand
 
+    int piecesGenerated;   // pieces whose moves the search built
+    int piecesToGenerate;  // pieces whose moves full generation would have built
+
+    // search a king's jump routes that lead to the same position only once; off by default, since
+    // the transposition table already catches the repeats and the check costs as much as it saves
+    bool collapseDuplicateCaptures;
+
+    int tableProbes;  // nodes looked up in the transposition table
+    int tableHits;    // lookups that found the position
+    int tableCutoffs; // hits whose stored score was used instead of searching
+
+    // try the hash move, the best jumps, the killer moves and the best history moves first, on by default
+    bool orderMoves;
+
+    // at the depth limit, follow pending jumps until the position is quiet before evaluating, on by default
+    bool useQuiescence;
+
+    int quiescenceNodes; // nodes past the depth limit whose jumps were searched
+
+    // Principal Variation Search tries later moves with null windows, on by default; off, it is plain negamax alpha-beta
+    bool nullWindows;
+
+    int nullWindowResearches; // moves that beat alpha on a null window and were searched again in full
+
+    int betaCutoffs;      // nodes left before all their moves were tried
+    int firstMoveCutoffs; // of those, the ones whose first move was enough
+
+    // search quiet moves late in a node's order less deep, unless they beat alpha, on by default
+    bool reduceLateMoves;
+
+    int lateMoveReductions; // moves searched at reduced depth
+    int lateMoveResearches; // of those, the ones searched again at full depth
+
+    // half the width of the root window around an expected score, set per evaluation function; 0 turns it off
+    int aspirationWindow;
+
+    int aspirationFailLows;  // root windows widened because the score fell below them
+    int aspirationFailHighs; // root windows widened because the score rose above them
+
     // minimax algorithm returns the position of the best move
-    Result minimax_a_b(Board board, int depth, Color color, int useThresh, int passThresh);
+    Result minimax_a_b(Board &state, int depth, Color color, int useThresh, int passThresh);
 
     // AB Prune algorithm
     Result alphaBetaSearch(Board state);
 
+    // Principal Variation Search, a negamax alpha-beta that tries to prove most moves worse with null windows
+    Result principalVariationSearch(Board state);
+
     void setEvalVersion(int evalVersion);
     void setMaxDepth(int maxDepth);
 
+    // stops the search at the given time; the result of a stopped search must not be used
+    void setDeadline(high_resolution_clock::time_point deadline);
+    bool wasStopped();
+
+    // searches the root with a window around the score expected, from an earlier search of the same parity
+    void setExpectedValue(int expectedValue);
+
+    // the starting aspirationWindow for an evaluation function
+    static int getDefaultAspirationWindow(int evalVersion);
+
+    // evalFunctOne switches to its endgame weights once the calling player has taken this many turns
+    static const int EVAL_ONE_ENDGAME_TURN = 40;
+
+    // which set of weights an evaluation function scores with after numTurns turns; scores of different phases do not mix
+    static int getEvaluationPhase(int evalVersion, int numTurns);
+
 private:
     int numNodesGenerated;
     int evalVersion;
     int currentDepth, maxDepth;
     Player callingPlayer;
+    std::shared_ptr<TranspositionTable> transpositionTable; // the calling player's, or null
+    MoveOrdering moveOrdering;                              // what this search learned about cutoffs
+
+    bool hasDeadline;
+    high_resolution_clock::time_point deadline;
+    bool isStopped;           // the deadline passed; every node returns at once
+    int nodesSinceClockCheck; // the clock is read every CLOCK_CHECK_INTERVAL nodes
+    static const int CLOCK_CHECK_INTERVAL = 256;
+
+    bool hasExpectedValue;
+    int expectedValue;
+    static const int ASPIRATION_WIDENING = 4;     // a failed window grows by this factor on the failing side
+    static const int ASPIRATION_MAX_RESEARCHES = 3; // after this many, the failing side is left open
+
+    // searches the root, within an aspiration window when an expected value is set
+    Result searchRoot(Board &state, bool isNegamax);
+
+    static const int LMR_MIN_DEPTH = 4;         // nodes with fewer plies left are never reduced
+    static const int LMR_FULL_DEPTH_MOVES = 3;  // the hash move and killers, usually
+    static const int LMR_TABLE_DEPTHS = 32;
+    static const int LMR_TABLE_MOVES = 64;
+
+    // plies to take off a move's search, always even so its leaves keep their parity
+    int getLateMoveReduction(int depth, int moveNumber, Board::PackedMove move);
+
+    // true once the deadline has passed
+    bool isOutOfTime();
 
     // plausible move generator, returns a list of positions that can be made by player
-    std::vector<Board::Move> movegen(Board board, Color color);
+    Board::MoveList movegen(Board &board, Color color);
 
     /* static evaluation functions return a number representing the 
     * goodness of Position from the standpoint of Player
     * A helper function staticEval is used to determine which evalFunction to use
     */
-    int evalFunctOne(Board state, Color color);
-    int evalFunctTwo(Board state, Color color);
-    int evalFunctThree(Board state, Color color);
+    int evalFunctOne(Board &state, Color color);
+    int evalFunctTwo(Board &state, Color color);
+    int evalFunctThree(Board &state, Color color);
 
     // wrapper function that will decide which of the actual three eval functions to call
-    int staticEval(Board state, Color color, int evalVersion);
+    int staticEval(Board &state, Color color, int evalVersion);
 
     // if true, return the structure
     bool deepEnough(int currentDepth);
 
-    bool terminalTest(Board state, int depth); // terminal test for alpha-beta-search
-    Result maxValue(Board state, int depth, int alpha, int beta, Color color);
-    Result minValue(Board state, int depth, int alpha, int beta, Color color);
-    int utility(Board state);
-    std::vector<Board::Move> actions(Board state, Color color);
+    bool terminalTest(Board &state, int depth); // terminal test for alpha-beta-search
+    Result maxValue(Board &state, int depth, int alpha, int beta, Color color);
+    Result minValue(Board &state, int depth, int alpha, int beta, Color color);
+
+    // the search nodes compiled per color; the versions taking a Color pick one of these and start them at ply 0.
+    // ply is how far the node is below the root, which depth no longer tells once late moves are reduced
+    template <Color color>
+    Result minimax_a_b(Board &state, int depth, int ply, int useThresh, int passThresh);
+    template <Color color>
+    Result maxValue(Board &state, int depth, int ply, int alpha, int beta);
+    template <Color color>
+    Result minValue(Board &state, int depth, int ply, int alpha, int beta);
+    template <Color color>
+    Result pvsValue(Board &state, int depth, int ply, int alpha, int beta);
+
+    // the score of a node at the depth limit: its evaluation, or with useQuiescence that of its quiescence search
+    template <Color color>
+    int horizonValue(Board &state, int ply, int alpha, int beta);
+    template <Color color>
+    int quiescence(Board &state, int alpha, int beta, Color evalColor, int ply);
+    int utility(Board &state);
+    Board::MoveList actions(Board &state, Color color);
 
     Color switchPlayerColor(Color color);
 
+    // adds a node's move picker work to piecesGenerated and piecesToGenerate
+    template <Color color>
+    void countGeneratedPieces(MovePicker<color> &picker);
+
+    // counts a cutoff at a node and teaches it to the move ordering
+    void recordCutoff(Color color, Board::PackedMove move, int ply, int depth, int moveNumber);
+
+    // a node's use of the transposition table, for the window the node was entered with
+    bool probeTable(uint64_t key, int depth, int alpha, int beta, Result &result, Board::PackedMove &hashMove);
+    void storeTable(uint64_t key, int depth, int alpha, int beta, const Result &result);
+
     int passSign(int passthresh);
 };
 
@@ -0,0 +1,95 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <atomic>
+#include <unordered_set>
+
+#include "Board.hpp"
+#include "Pieces.hpp"
+
+/**
+ * Header definition for class Benchmark.
+ *
+ * The Benchmark class runs parts of the engine outside of a game so that they can be measured
+ * on their own. It is started with the -bench CLI argument and prints its results to the console.
+ * Debug output is turned off while it runs, since printing would dominate every timing.
+ *
+ * The positions used are reached by playing a fixed sequence of moves from the initial board,
+ * so every run measures the same work. Each search benchmark measures one feature, so late move
+ * reductions, which change both nodes and values, are turned off everywhere but runTimeToDepth.
+ */
+
+class Benchmark
+{
+
+private:
+    // plays numPlies moves from the initial board, choosing moves by a fixed pattern
+    static Board playFixedOpening(int numPlies, Color &sideToMove);
+
+    // sets up a random endgame with several kings on each side, the same for the same seed
+    static Board makeKingEndgame(unsigned long long &seed);
+
+    // adds the hash key and canonical hash key of every position within depth plies of state
+    static void collectKeys(Board &state, int depth, std::unordered_set<uint64_t> &keys,
+                            std::unordered_set<uint64_t> &canonicalKeys);
+
+public:
+    Benchmark();  // constructor
+    ~Benchmark(); // destructor
+
+    // runs every benchmark in turn
+    void runAll();
+
+    // times the first Board construction, later constructions and updateBoard
+    void runBoardConstruction();
+
+    // times the game loop's win checks, by move list size and by Board::hasAnyMove
+    void runWinChecks();
+
+    // reports how much move generation the searches skip by building moves lazily
+    void runSkippedGeneration();
+
+    // counts heap allocations made by each search, reported per searched node
+    void runAllocationCount();
+
+    // times reading and writing positions as text
+    void runPositionText();
+
+    // times the piece masks of many boards, one board at a time and by BoardBatch
+    void runBatchMoveMasks();
+
+    // measures moves and searched nodes saved by collapsing duplicate king captures
+    void runDuplicateCaptures();
+
+    // counts the positions that share a canonical key with their flipped version
+    void runCanonicalKeys();
+
+    // times the attacked-piece masks against finding the same pieces from move lists
+    void runThreatMasks();
+
+    // times checking stored moves with Board::isLegal against searching the move list
+    void runLegalityChecks();
+
+    // compares searches with and without a transposition table at depths 6 to 12
+    void runTranspositionTable();
+
+    // compares searches with and without move ordering, by nodes and first move cutoffs
+    void runMoveOrdering();
+
+    // compares Alpha-Beta search with Principal Variation Search at depths 6 to 12
+    void runPrincipalVariation();
+
+    // compares root searches with and without aspiration windows, for each evaluation function
+    void runAspirationWindows();
+
+    // compares shallow searches with and without quiescence against a deep search
+    void runQuiescence();
+
+    // compares the time iterative deepening takes to reach each depth with and without late move reductions
+    void runTimeToDepth();
+
+    // incremented by the replacement global operator new in Benchmark.cpp, built with COUNT_ALLOCATIONS
+    static std::atomic<long long> allocationCount;
+};
+
+#endif // !BENCHMARK_H
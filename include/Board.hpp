@@ -1,9 +1,12 @@
 #ifndef BOARD_H
 #define BOARD_H
 
+#include <cassert>
 #include <vector>
 #include <string>
 #include <chrono>
+#include <cstdint>
+#include <type_traits>
 
 using std::chrono::high_resolution_clock;
 using std::chrono::duration_cast;
@@ -18,67 +21,375 @@ using std::chrono::milliseconds;
 
 /**
  * Class board is used to represent the entire board and its current state.
- * It is based on an 8 x 8 grid, with 32 possible spaces. Two piece data
- * types are the primary memory consumers of this class. This class also includes 
- * a static member that acts as a move guide. This move guide determines the possible
+ * It is based on an 8 x 8 grid, with 32 possible spaces. The state is three
+ * 32 bit fields, one bit per square: the red pieces, the black pieces and the
+ * kings of either color, plus the player to move and the position's hash key.
+ * A board is trivially copyable and 24 bytes, so boards can be copied and stored
+ * in bulk. This class also includes 
+ * a static, compile time member that acts as a move guide. This move guide determines the possible
  * moves for a square on the board, not for a piece. 
  */
 class Board
 {
 
 public:
+	/**
+	* Struct SquareList is a short, fixed capacity list of squares. It is
+	* used in place of a vector so that a move never touches the heap.
+	* A jump chain can take at most 12 pieces, which bounds its length.
+	*/
+	struct SquareList
+	{
+		static const int MAX_SQUARES = 12;
+
+		SquareList() : count(0) {}
+
+		int size() const { return count; }
+		int at(int index) const { return squares[index]; }
+		int back() const { return squares[count - 1]; }
+		void push_back(int square)
+		{
+			assert(count < MAX_SQUARES);
+			squares[count++] = (signed char)square;
+		}
+		void pop_back() { count--; }
+		void clear() { count = 0; }
+
+	private:
+		signed char squares[MAX_SQUARES];
+		signed char count;
+	};
+
 	/**
 	* Struct Nove is used to track moves made on the board. It contains
-	* a single starting location, a vector of steps to a move, 
+	* a single starting location, a list of steps to a move, 
 	* as well as all of the pieces to remove when this move is made.
 	*/
 	struct Move
 	{
 		int startSquare;
-		std::vector<int> destinationSquare;
-		std::vector<int> removalSquare;
+		SquareList destinationSquare;
+		SquareList removalSquare;
+	};
+
+	/**
+	* Struct PackedMove holds a move in 32 bits: the start square, the end
+	* square and the pieces taken. That is enough to replay any jump
+	* chain, since the squares landed on in between follow from the
+	* pieces taken. Only the 18 squares off the edges of the board can
+	* be jumped, so the captures are kept as an 18 bit field over those.
+	* Bits 0 - 4 hold the start square, 5 - 9 the end square and 10 - 27
+	* the captures. All zero bits is the null move.
+	*/
+	struct PackedMove
+	{
+		PackedMove() : bits(0) {}
+		PackedMove(int startSquare, int endSquare, uint32_t capturedSquares)
+			: bits((uint32_t)(startSquare - 1) | ((uint32_t)(endSquare - 1) << 5) |
+				   ((((capturedSquares >> 5) & 0x3F) | ((capturedSquares >> 7) & 0xFC0) | ((capturedSquares >> 9) & 0x3F000)) << 10))
+		{
+		}
+
+		int getStartSquare() const { return (bits & 0x1F) + 1; }
+		int getEndSquare() const { return ((bits >> 5) & 0x1F) + 1; }
+
+		// The captured squares as a bit field over the whole board, bit 0 being square 1.
+		uint32_t getCapturedSquares() const
+		{
+			uint32_t captures = bits >> 10;
+			return ((captures & 0x3F) << 5) | ((captures & 0xFC0) << 7) | ((captures & 0x3F000) << 9);
+		}
+
+		bool isCapture() const { return (bits >> 10) != 0; }
+		bool isNull() const { return bits == 0; }
+		bool operator==(const PackedMove &other) const { return bits == other.bits; }
+		bool operator!=(const PackedMove &other) const { return bits != other.bits; }
+
+		uint32_t bits;
 	};
 
 	/**
-	* Struct BoardMoveTable is a static data type that is used to speed
-	* up searching for moves for each position. It is shared among all
-	* boards.
+	* Struct MoveList holds every move generated for a position. It has a
+	* fixed capacity and lives on the stack of whoever asks for the moves,
+	* so generating and searching moves does not allocate.
+	*/
+	struct MoveList
+	{
+		static const int MAX_MOVES = 128;
+
+		MoveList() : count(0) {}
+
+		int size() const { return count; }
+		const Move &at(int index) const { return moves[index]; }
+		Move &at(int index) { return moves[index]; }
+		void push_back(const Move &move)
+		{
+			// no position has that many moves, so a full list means a generator bug
+			assert(count < MAX_MOVES);
+
+			if (count < MAX_MOVES)
+			{
+				moves[count++] = move;
+			}
+		}
+		void clear() { count = 0; }
+
+	private:
+		Move moves[MAX_MOVES];
+		int count;
+	};
+
+	/**
+	* Struct Undo records what makeMove changed beyond the move itself,
+	* so that unmakeMove can restore the board: the captured squares,
+	* which of them held kings, whether the moving piece was kinged and
+	* the hash key before the move.
+	*/
+	struct Undo
+	{
+		uint32_t capturedSquares;
+		uint32_t capturedKings;
+		bool wasPromoted;
+		uint64_t hashKey;
+	};
+
+	/**
+	* Struct BoardMoveTable describes the board around one square, not
+	* the pieces on it. Each direction is indexed up-left, up-right,
+	* down-left, down-right, which also lists the squares in ascending
+	* order, and holds 0 where the board ends. The table is built at
+	* compile time and shared among all boards.
 	*/
 	struct BoardMoveTable
 	{
-		std::vector<int> jumps;
-		std::vector<int> removals;
-		std::vector<int> moves;
+		int moves[4];		// square one diagonal step away
+		int jumps[4];		// square a jump lands on
+		int removals[4];	// square a jump passes over
+		uint32_t moveMask;	// moves as a bit field
+		uint32_t jumpMask;	// jumps as a bit field
 	};
 
+	/**
+	* Struct ZobristKeys holds the random keys of one square, one for
+	* each piece that can stand on it, indexed red then black. A board's
+	* hash key is the XOR of the keys of its pieces, and of the side key
+	* when red is to move. The keys are worked out by the compiler from
+	* a fixed seed, so a key is the same in every run and every build.
+	* Black keys mirror red ones, see makeZobristEntry.
+	*/
+	struct ZobristKeys
+	{
+		uint64_t men[2];
+		uint64_t kings[2];
+	};
+
+	static const int UP_LEFT = 0;
+	static const int UP_RIGHT = 1;
+	static const int DOWN_LEFT = 2;
+	static const int DOWN_RIGHT = 3;
+
 	Board();
-	~Board();
-	static void InitializeMoveTable();
-	std::vector<Move> moveGen(Color color);
+	MoveList moveGen(Color color, bool collapseDuplicateCaptures = false);
+
+	uint32_t getMovablePiecesMask(Color color);
+	uint32_t getJumpingPiecesMask(Color color);
+	bool hasAnyMove(Color color);
+	bool hasAnyJump(Color color);
+
+	// Pieces of the player that the opponent could take with a jump right
+	// now, and the ones among them the player could not take back.
+	uint32_t getAttackedMask(Color color) const;
+	uint32_t getHangingMask(Color color) const;
 
 	void printBoard() const;
 	Board updateBoard(Move move, Color color);
+	void makeMove(const Move &move, Color color, Undo &undo);
+	void unmakeMove(const Move &move, Color color, const Undo &undo);
+	void makeMove(PackedMove move, Color color, Undo &undo);
+	void unmakeMove(PackedMove move, Color color, const Undo &undo);
+
+	static PackedMove packMove(const Move &move);
+	Move unpackMove(PackedMove move, Color color);
+
+	// Whether a move, for example one kept from another search, is one
+	// moveGen would list here. Works from the masks, without the list.
+	bool isLegal(PackedMove move, Color color);
+
+	// Reads and writes a position as one line of text, for example
+	// "B:R1,2,K29:B21-32". See parsePosition in Board.cpp.
+	static bool parsePosition(const std::string &position, Board &board);
+	std::string toPosition() const;
+	Color getSideToMove() const;
+
+	// The 64 bit Zobrist key of the position, kept up to date by
+	// makeMove and unmakeMove, and the same key worked out from scratch.
+	uint64_t getHashKey() const;
+	uint64_t computeHashKey() const;
+
+	// The position with colors swapped and the board turned around, which
+	// plays the same. The canonical form is whichever of the two has black
+	// to move; isFlipped says whether that is the flipped one.
+	Board getFlippedBoard() const;
+	Board getCanonicalBoard(bool &isFlipped) const;
+	uint64_t getCanonicalHashKey(bool &isFlipped) const;
+	static PackedMove flipMove(PackedMove move);
+
+	// The same operations compiled once per color, so the direction of
+	// travel and the kinging row are constants. The versions above that
+	// take a Color pick one of these. Both colors are instantiated in
+	// Board.cpp.
+	template <Color color>
+	MoveList moveGen(bool collapseDuplicateCaptures = false);
+	template <Color color>
+	uint32_t getMovablePiecesMask();
+	template <Color color>
+	uint32_t getJumpingPiecesMask();
+	template <Color color>
+	bool isLegal(PackedMove move);
+	template <Color color>
+	uint32_t getAttackedMask() const;
+	template <Color color>
+	uint32_t getHangingMask() const;
+	template <Color color>
+	void makeMove(PackedMove move, Undo &undo);
+	template <Color color>
+	void unmakeMove(PackedMove move, const Undo &undo);
+	template <Color color>
+	void getJumpsForPiece(int square, MoveList &moves, bool collapseDuplicateCaptures = false);
+	template <Color color>
+	void getMovesForPiece(int square, MoveList &moves);
+
+	static constexpr Color getOpponentColor(Color color)
+	{
+		return color == Color::RED ? Color::BLACK : Color::RED;
+	}
 
 	int getNumRegularPieces(Color color);
 	int getNumKingPieces(Color color);
 	int getNumPlayerTotalPieces(Color color);
 	int getPieceInSquare(int square, Color color);
 
-	std::vector<Move> getJumpsForPiece(Color color, int square, Pieces *playerPieces, Pieces *opponentPieces);
-	std::vector<Move> getMovesForPiece(Color color, int square, Pieces *playerPieces, Pieces *opponentPieces);
-
-	Pieces getPlayerPieces(Color color);
-	Pieces getOpponentPieces(Color color);
+	uint32_t getPiecesMask(Color color) const;
+	uint32_t getKingsMask(Color color) const;
 
-	static BoardMoveTable boardMoveTable[33];
+	static const BoardMoveTable boardMoveTable[33];
+	static const ZobristKeys zobristKeys[33];
+	static const uint64_t zobristRedToMove;
 
 
 
 private:
-	Pieces blackPieces;
-	Pieces redPieces;
+	// BoardBatch runs the mask functions below over many boards at once.
+	friend class BoardBatch;
+
+	uint32_t redSquares;
+	uint32_t blackSquares;
+	uint32_t kings; // kings of both colors
+
+	// The player to move. Black moves first; makeMove and unmakeMove
+	// hand the turn over and back.
+	Color sideToMove;
+
+	uint64_t hashKey;
+
+	// Squares 1 - 4, 9 - 12, 17 - 20 and 25 - 28 sit one column to the right of
+	// the rows in between, so a diagonal step from them shifts by 4 or 5 bits
+	// instead of 3 or 4. The edge masks mark the squares with only one diagonal
+	// on a side.
+	static const uint32_t SHIFTED_ROW_MASK = 0x0F0F0F0F;
+	static const uint32_t UNSHIFTED_ROW_MASK = 0xF0F0F0F0;
+	static const uint32_t LEFT_EDGE_MASK = 0x10101010;
+	static const uint32_t RIGHT_EDGE_MASK = 0x08080808;
 
-	void getJumpsForPieceRec(Color color, Board::Move move, std::vector<Board::Move> &totalMoves, Board board, bool wasKingPriorMove);
+	// Red starts on squares 1 - 12 and black on 21 - 32.
+	static const uint32_t RED_START_MASK = 0x00000FFF;
+	static const uint32_t BLACK_START_MASK = 0xFFF00000;
+	static const uint64_t INITIAL_HASH_KEY;
+
+	// A man is kinged on the back row of the opposing player.
+	static const uint32_t RED_KING_ROW_MASK = 0xF0000000;
+	static const uint32_t BLACK_KING_ROW_MASK = 0x0000000F;
+
+	// Move every square in the bit field one diagonal step. Down is towards
+	// square 32. Squares that would leave the board are dropped, either by
+	// the edge masks or by shifting out of the 32 bits. They are defined
+	// here so that BoardBatch can inline them too.
+	static uint32_t stepDownLeft(uint32_t squares)
+	{
+		return ((squares & SHIFTED_ROW_MASK) << 4) | ((squares & UNSHIFTED_ROW_MASK & ~LEFT_EDGE_MASK) << 3);
+	}
+
+	static uint32_t stepDownRight(uint32_t squares)
+	{
+		return ((squares & SHIFTED_ROW_MASK & ~RIGHT_EDGE_MASK) << 5) | ((squares & UNSHIFTED_ROW_MASK) << 4);
+	}
+
+	static uint32_t stepUpLeft(uint32_t squares)
+	{
+		return ((squares & SHIFTED_ROW_MASK) >> 4) | ((squares & UNSHIFTED_ROW_MASK & ~LEFT_EDGE_MASK) >> 5);
+	}
+
+	static uint32_t stepUpRight(uint32_t squares)
+	{
+		return ((squares & SHIFTED_ROW_MASK & ~RIGHT_EDGE_MASK) >> 3) | ((squares & UNSHIFTED_ROW_MASK) >> 4);
+	}
+
+	// The step above in one of the four directions, and the direction
+	// back. With a constant direction this folds to a single step.
+	static uint32_t stepSquares(uint32_t squares, int direction)
+	{
+		switch (direction)
+		{
+		case UP_LEFT:
+			return stepUpLeft(squares);
+		case UP_RIGHT:
+			return stepUpRight(squares);
+		case DOWN_LEFT:
+			return stepDownLeft(squares);
+		default:
+			return stepDownRight(squares);
+		}
+	}
+
+	static constexpr int getOppositeDirection(int direction)
+	{
+		return DOWN_RIGHT - direction;
+	}
+
+	static constexpr int getDiagonalSquare(int square, int direction, int distance);
+	static constexpr int getSquareAt(int row, int column);
+	static constexpr uint32_t getSquareBit(int square);
+	static constexpr BoardMoveTable makeMoveTableEntry(int square);
+	static constexpr uint64_t mixZobristBits(uint64_t bits, int shift, uint64_t multiplier);
+	static constexpr uint64_t getZobristKey(uint64_t index);
+	static constexpr uint64_t swapKeyHalves(uint64_t key);
+	static constexpr ZobristKeys makeZobristEntry(int square);
+	static uint32_t reverseSquares(uint32_t squares);
+	static constexpr uint64_t getInitialHashKey(int square);
+
+	static int parseSquare(const char *&text);
+	static void appendSquares(std::string &position, uint32_t squares, uint32_t kings);
+
+	template <Color color>
+	uint32_t &getSquaresOf();
+	template <Color color>
+	static uint32_t getKingRowMask();
+	template <Color color>
+	uint32_t getPiecesMovingToward(uint32_t squares, int direction) const;
+	template <Color color, int direction>
+	uint32_t getAttackedAlong(uint32_t playerSquares, uint32_t opponentSquares) const;
+	template <Color color, int direction>
+	uint32_t getHangingAlong(uint32_t playerSquares, uint32_t opponentSquares) const;
+	template <Color color>
+	static uint32_t getStepTargets(uint32_t square, bool isKing);
+	template <Color color>
+	static uint32_t getJumpTargets(uint32_t square, bool isKing, uint32_t opponentSquares, uint32_t emptySquares);
+	template <Color color>
+	static bool hasJumpRoute(uint32_t square, bool isKing, uint32_t capturedSquares, uint32_t endSquare,
+							 uint32_t opponentSquares, uint32_t emptySquares);
 };
 
+static_assert(std::is_trivially_copyable<Board>::value, "Board must copy as plain memory");
+static_assert(sizeof(Board) <= 24, "Board must stay three bit fields, a side to move and a hash key");
+
 #endif
\ No newline at end of file
@@ -0,0 +1,57 @@
+#ifndef BOARDBATCH_H
+#define BOARDBATCH_H
+
+#include <cstdint>
+#include <vector>
+
+#include "Board.hpp"
+#include "Pieces.hpp"
+
+/**
+ * Header definition for class BoardBatch.
+ *
+ * A BoardBatch holds many independent boards as a structure of arrays: all red squares in one
+ * array, all black squares in another, then the kings and the side to move. Self-play, data
+ * generation and perft handle large numbers of positions, and this layout lets the piece masks
+ * of several boards be computed by one vector instruction.
+ *
+ * computeMoveMasks gives, for every board and its side to move, the same masks as
+ * Board::getMovablePiecesMask and Board::getJumpingPiecesMask. Where the CPU has AVX2, 8 boards
+ * are handled per instruction; elsewhere the same steps run one board at a time. The AVX2 code is
+ * chosen at run time, so no extra compiler flags are needed.
+ */
+
+class BoardBatch
+{
+
+public:
+    static const int BOARDS_PER_VECTOR = 8; // 32 bit masks in a 256 bit register
+
+    BoardBatch();  // constructor
+    ~BoardBatch(); // destructor
+
+    void add(const Board &board);
+    void clear();
+    int size() const;
+    Board getBoard(int index) const;
+
+    // fills the movable and jumping piece masks of every board, for the side to move
+    void computeMoveMasks(std::vector<uint32_t> &movablePieces, std::vector<uint32_t> &jumpingPieces) const;
+
+    // the same, one board at a time, whatever the CPU supports
+    void computeMoveMasksScalar(std::vector<uint32_t> &movablePieces, std::vector<uint32_t> &jumpingPieces) const;
+
+    // true if computeMoveMasks uses AVX2 on this CPU
+    static bool isVectorized();
+
+private:
+    std::vector<uint32_t> redSquares;
+    std::vector<uint32_t> blackSquares;
+    std::vector<uint32_t> kings;
+    std::vector<uint32_t> redToMove; // all ones if red is to move, zero if black is
+
+    void computeMoveMasksScalar(int first, int last, uint32_t *movablePieces, uint32_t *jumpingPieces) const;
+    void computeMoveMasksVector(int first, int last, uint32_t *movablePieces, uint32_t *jumpingPieces) const;
+};
+
+#endif // !BOARDBATCH_H
@@ -36,7 +36,7 @@ private:
 public:
     Game();                          // constructor
     ~Game();                         // destructor
-    Game(bool, int, bool, int, int); // player1 algo, eval version, player2 algo, eval version, depth
+    Game(bool, int, bool, int, int, int timePerMoveMs = 0, bool usePrincipalVariation = false); // player1 algo, eval version, player2 algo, eval version, depth, ms per move (0 = fixed depth), PVS for AB Prune
 
     enum class GameOver
     {
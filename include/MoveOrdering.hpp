@@ -0,0 +1,47 @@
+#ifndef MOVEORDERING_H
+#define MOVEORDERING_H
+
+#include "Board.hpp"
+#include "Pieces.hpp"
+
+/**
+ * Header definition for class MoveOrdering.
+ *
+ * Alpha-beta prunes the most when the best move of a node is tried first. MoveOrdering keeps what
+ * a search has learned about which quiet moves cause cutoffs, for MovePicker to try those moves
+ * early:
+ *
+ *    - two killer moves per ply: the last quiet moves that caused a cutoff at that distance from
+ *      the root. Sibling positions often share a refutation.
+ *    - a butterfly history table: for each color, start square and end square, the sum of
+ *      depth * depth over every cutoff the quiet move caused anywhere in the search.
+ *
+ * Captures need neither, since they are ordered by the number of pieces they take, and the hash
+ * move comes from the transposition table. One MoveOrdering lives for one search.
+ */
+
+class MoveOrdering
+{
+
+public:
+    static const int MAX_PLY = 64;          // killers are kept for plies 0 to MAX_PLY - 1
+    static const int KILLERS_PER_PLY = 2;
+    static const int HISTORY_LIMIT = 1 << 20; // the table is halved when a score reaches it
+
+    MoveOrdering();  // constructor
+    ~MoveOrdering(); // destructor
+
+    // records a move that caused a cutoff, depth plies from the bottom and ply plies from the root
+    void addCutoff(Color color, Board::PackedMove move, int ply, int depth);
+
+    Board::PackedMove getKiller(int ply, int killerIndex) const;
+    int getHistoryScore(Color color, Board::PackedMove move) const;
+
+    void clear();
+
+private:
+    Board::PackedMove killers[MAX_PLY][KILLERS_PER_PLY];
+    int history[2][32][32]; // [red, black][start square - 1][end square - 1]
+};
+
+#endif // !MOVEORDERING_H
@@ -0,0 +1,92 @@
+#ifndef MOVEPICKER_H
+#define MOVEPICKER_H
+
+#include <cstdint>
+
+#include "Board.hpp"
+#include "MoveOrdering.hpp"
+#include "Pieces.hpp"
+
+/**
+ * Header definition for class MovePicker.
+ *
+ * The MovePicker class hands out the legal moves of one position one at a time, building them
+ * only as they are asked for. Jumps are mandatory in checkers, so the jump stage comes first and
+ * the quiet move stage is only entered when no piece can jump. Within a stage, moves are built one
+ * piece at a time, lowest square first, so a search that cuts off after its first few moves never
+ * builds the moves of the remaining pieces.
+ *
+ * Moves come out packed, in exactly the order Board::moveGen lists them. The picker is compiled once per
+ * color, like the Board generation it calls, and is instantiated for both colors in MovePicker.cpp.
+ *
+ * Given a MoveOrdering, the picker hands moves out best guess first instead: the hash move, then the
+ * jumps by number of pieces taken, then the killer moves of the ply, then the quiet moves by
+ * history score. The hash move and killers are checked with Board::isLegal and handed out before
+ * anything is built, and each later stage builds the moves of all its pieces at once to sort them.
+ * Every move is still handed out exactly once.
+ *
+ * With collapseDuplicateCaptures, a king's jump routes that lead to the same position are handed
+ * out once, see Board::getJumpsForPiece.
+ *
+ * The board is held by reference. It may be changed between calls to nextMove, as long as it is
+ * back in the same position when nextMove is called again, which is how make/unmake search uses it.
+ */
+
+template <Color color>
+class MovePicker
+{
+
+public:
+    enum Stage
+    {
+        HASH_MOVE,    // ordered only
+        JUMPS,
+        KILLER_MOVES, // ordered only
+        QUIET_MOVES,
+        DONE
+    };
+
+    MovePicker(Board &state, bool collapseDuplicateCaptures = false); // constructor
+
+    // ordered picker; ply is the distance of the position from the root, for its killer moves
+    MovePicker(Board &state, bool collapseDuplicateCaptures, const MoveOrdering *ordering,
+               Board::PackedMove hashMove, int ply);
+    ~MovePicker();                                                     // destructor
+
+    // gets the next move, returns false once every move has been handed out
+    bool nextMove(Board::PackedMove &move);
+
+    Stage getStage();
+
+    int getNumPiecesGenerated(); // pieces whose moves have been built so far
+    int getNumPiecesToGenerate(); // pieces a full move generation would build moves for
+
+private:
+    Board &state;
+    Stage stage;
+    bool collapseDuplicateCaptures;
+
+    uint32_t piecesLeft;        // pieces of the current stage whose moves are not built yet
+    Board::MoveList pieceMoves; // moves of the piece currently being handed out
+    int pieceMoveIndex;
+
+    int numPiecesGenerated;
+    int numPiecesToGenerate;
+
+    const MoveOrdering *ordering; // null hands moves out in generation order
+    Board::PackedMove hashMove;   // null once it is known not to be legal
+    int ply;
+    int killerIndex;
+    bool hasJumps;
+
+    // the moves of an ordered stage and their scores, handed out highest score first
+    Board::PackedMove orderedMoves[Board::MoveList::MAX_MOVES];
+    int orderedScores[Board::MoveList::MAX_MOVES];
+    int numOrderedMoves;
+    int orderedMoveIndex;
+
+    bool nextOrderedMove(Board::PackedMove &move);
+    void buildOrderedMoves(); // builds the moves of every piece left in the stage and scores them
+};
+
+#endif // !MOVEPICKER_H
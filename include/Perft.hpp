@@ -0,0 +1,45 @@
+#ifndef PERFT_H
+#define PERFT_H
+
+#include "Board.hpp"
+#include "Pieces.hpp"
+
+/**
+ * Header definition for class Perft.
+ *
+ * Perft (performance test) walks every legal move sequence to a fixed depth and counts the
+ * positions reached. The counts depend only on the rules, so they check a move generator
+ * against published numbers, and the time taken measures move generation and make/unmake
+ * with no evaluation or pruning mixed in. It is started with the -perft CLI argument.
+ *
+ * With bulk counting the last ply is not played out: the number of moves generated there is
+ * the number of leaf nodes. The work can be split across threads at the root, each thread
+ * taking the next root move not yet counted, on its own copy of the board.
+ */
+
+class Perft
+{
+
+private:
+    template <Color color>
+    static long long countNodes(Board &state, int depth, bool bulkCount);
+
+public:
+    Perft();  // constructor
+    ~Perft(); // destructor
+
+    // counts the positions depth plies below state, color to move
+    static long long countNodes(Board &state, Color color, int depth, bool bulkCount);
+
+    // same count, with the root moves shared among numThreads threads
+    static long long countNodesThreaded(const Board &state, Color color, int depth, bool bulkCount, int numThreads);
+
+    // counts each depth from 1 to maxDepth and prints the counts and nodes per second
+    void run(const Board &state, Color color, int maxDepth, int numThreads, bool bulkCount);
+
+    // published counts from the initial position, Black to move, for depths 1 to 12
+    static const int NUM_KNOWN_COUNTS = 12;
+    static const long long INITIAL_POSITION_COUNTS[NUM_KNOWN_COUNTS + 1];
+};
+
+#endif // !PERFT_H
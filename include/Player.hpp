@@ -3,6 +3,9 @@
 
 #include "Pieces.hpp"
 #include "Board.hpp"
+#include "TranspositionTable.hpp"
+
+#include <memory>
 
 /**
  * Header definition for class Player.
@@ -25,6 +28,34 @@ private:
 
     int depth, evalVersion;
 
+    // Kept from turn to turn, so each search can reuse the results of the last.
+    // Shared, since the searches get a copy of the Player.
+    std::shared_ptr<TranspositionTable> transpositionTable;
+    int evaluationPhase; // the Algorithm::getEvaluationPhase the stored scores were searched in
+
+    // With a time budget, takeTurn deepens one ply at a time until it runs out,
+    // and depth is the deepest search it starts. 0 searches to depth at once.
+    int timePerMoveMs;
+    int lastSearchDepth; // depth of the search the last move came from
+
+    // Alpha-Beta players search with principalVariationSearch instead of alphaBetaSearch
+    bool usePrincipalVariation;
+
+    // The root score of the last finished Alpha-Beta search of each depth and the turn it was
+    // made in, to centre the aspiration window of a later search of the same depth parity.
+    static const int MAX_SEARCH_DEPTH = 15;
+    int searchScores[MAX_SEARCH_DEPTH + 1];
+    int searchScoreTurns[MAX_SEARCH_DEPTH + 1];
+
+    // the score a search of searchDepth is expected to get; false if there is no earlier search to go by
+    bool getExpectedValue(int searchDepth, int &expectedValue);
+    void clearSearchScores();
+
+    // one search of the player's algorithm; false if it stopped at the deadline
+    bool searchToDepth(Board &state, int searchDepth, bool hasDeadline, high_resolution_clock::time_point deadline,
+                       Board::PackedMove &bestMove);
+    Board::PackedMove searchWithTimeBudget(Board &state);
+
 public:
     Player();  // constructor
     ~Player(); // destructor
@@ -40,6 +71,17 @@ public:
     bool getDidPlayerMove();
     Color getColor();
 
+    // the table the player's searches use; null turns it off
+    std::shared_ptr<TranspositionTable> getTranspositionTable();
+    void setTranspositionTable(std::shared_ptr<TranspositionTable> transpositionTable);
+
+    void setTimePerMove(int timePerMoveMs);
+    int getTimePerMove();
+    int getLastSearchDepth();
+
+    void setPrincipalVariationSearch(bool usePrincipalVariation);
+    bool getPrincipalVariationSearch();
+
     void decreaseNumPieces(int numPiecesToDecreaseCount);
     void increaseNumPiecesTaken(int numPiecesToIncreaseScore);
 
@@ -50,6 +92,12 @@ public:
     int absearchExpandedNodes; // how many nodes we expand
     int absearchLeafNodes;     // how many nodes we expand
 
+    int quiescenceNodes;     // nodes searched past the depth limit, see Algorithm::quiescence
+    int aspirationFailLows;  // root searches widened after failing low, see Algorithm::searchRoot
+    int aspirationFailHighs; // root searches widened after failing high
+    int lateMoveReductions;  // moves searched at reduced depth, see Algorithm::getLateMoveReduction
+    int lateMoveResearches;  // of those, the ones searched again at full depth
+
     int getMinimaxTotalNodes()
     {
         return minimaxExpandedNodes + minimaxLeafNodes;
@@ -65,6 +65,8 @@ class Simulation
 
 private:
     int numGamesPlayed;
+    int timePerMoveMs; // 0 searches to the depth given; otherwise the depth is the deepest search
+    bool usePrincipalVariation; // AB Prune players use Principal Variation Search
 
     // runs only games using Minimax algorithm
     void runMinimaxOnly();
@@ -76,6 +78,12 @@ public:
     Simulation();  // constructor
     ~Simulation(); // destructor
 
+    // gives every computer move a time budget in milliseconds, 0 for none
+    void setTimePerMove(int timePerMoveMs);
+
+    // has AB Prune players search with Principal Variation Search
+    void setPrincipalVariationSearch(bool usePrincipalVariation);
+
     // runs all games runs as delineated above
     void runFullSimulation();
 
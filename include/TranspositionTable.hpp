@@ -0,0 +1,92 @@
+#ifndef TRANSPOSITIONTABLE_H
+#define TRANSPOSITIONTABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "Board.hpp"
+
+/**
+ * Header definition for class TranspositionTable.
+ *
+ * The same position is often reached by different move orders, and more so once kings can move
+ * back and forth. The table keeps the result of searching a position under its Board hash key,
+ * so the searches in Algorithm can reuse it instead of searching the position again.
+ *
+ * The table has a fixed size chosen when it is made. It is split into buckets of four 16 byte
+ * entries, one 64 byte cache line each, and a key only ever goes to one bucket. Each entry keeps
+ * the depth searched, whether the score is exact or a bound, the score and the best move found.
+ * Which entry of a full bucket gives way to a new result is set by the replacement policy.
+ */
+
+class TranspositionTable
+{
+
+public:
+    // how a stored score relates to the true score of the position
+    enum Bound
+    {
+        NO_BOUND,    // empty entry
+        UPPER_BOUND, // every move was tried and none reached alpha
+        LOWER_BOUND, // a move reached beta and the rest were skipped
+        EXACT        // the score lies inside the window it was searched with
+    };
+
+    enum ReplacementPolicy
+    {
+        DEPTH_PREFERRED, // a full bucket keeps its deepest results of the current search
+        ALWAYS_REPLACE   // the newest result always goes in
+    };
+
+    struct Entry
+    {
+        uint32_t keyCheck;       // upper half of the hash key; the lower bits chose the bucket
+        Board::PackedMove move;  // best move found, or the move that caused the cutoff
+        int32_t score;
+        int8_t depth;            // plies searched below the position
+        uint8_t bound;           // a Bound
+        uint8_t generation;      // the search that stored it, see newSearch
+        uint8_t padding;
+    };
+
+    static const int ENTRIES_PER_BUCKET = 4;
+    static const size_t DEFAULT_SIZE_MB = 16;
+
+    struct alignas(64) Bucket
+    {
+        Entry entries[ENTRIES_PER_BUCKET];
+    };
+
+    TranspositionTable(size_t sizeInMegabytes = DEFAULT_SIZE_MB, ReplacementPolicy policy = DEPTH_PREFERRED);
+    ~TranspositionTable(); // destructor
+
+    // finds the entry for a position; false if the table has none
+    bool probe(uint64_t key, Entry &entry) const;
+
+    // keeps the result of searching a position, subject to the replacement policy
+    void store(uint64_t key, int depth, Bound bound, int score, Board::PackedMove move);
+
+    // marks the start of a new search, so results from earlier ones give way first
+    void newSearch();
+
+    void clear();
+
+    size_t getNumEntries() const;
+    ReplacementPolicy getPolicy() const;
+
+private:
+    std::unique_ptr<char[]> memory; // the buckets, with room to line them up on a cache line
+    Bucket *buckets;
+    uint64_t bucketMask;            // number of buckets - 1, a power of two
+    ReplacementPolicy policy;
+    uint8_t generation;
+
+    TranspositionTable(const TranspositionTable &);
+    TranspositionTable &operator=(const TranspositionTable &);
+};
+
+static_assert(sizeof(TranspositionTable::Entry) == 16, "four entries must fill one cache line");
+static_assert(sizeof(TranspositionTable::Bucket) == 64, "a bucket must be one cache line");
+
+#endif // !TRANSPOSITIONTABLE_H
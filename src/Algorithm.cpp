@@ -1,5 +1,6 @@
 #include "Algorithm.hpp"
 
+#include <cmath>
 #include <limits>
 #include <stdexcept>
 #include <iostream>
@@ -10,6 +11,30 @@ Algorithm::Algorithm()
     this->minimaxExpandedNodes = 0;
     this->absearchLeafNodes = 0;
     this->absearchExpandedNodes = 0;
+    this->piecesGenerated = 0;
+    this->piecesToGenerate = 0;
+    this->collapseDuplicateCaptures = false;
+    this->tableProbes = 0;
+    this->tableHits = 0;
+    this->tableCutoffs = 0;
+    this->orderMoves = true;
+    this->nullWindows = true;
+    this->nullWindowResearches = 0;
+    this->betaCutoffs = 0;
+    this->firstMoveCutoffs = 0;
+    this->useQuiescence = true;
+    this->quiescenceNodes = 0;
+    this->reduceLateMoves = true;
+    this->lateMoveReductions = 0;
+    this->lateMoveResearches = 0;
+    this->aspirationWindow = 0;
+    this->aspirationFailLows = 0;
+    this->aspirationFailHighs = 0;
+    this->hasExpectedValue = false;
+    this->expectedValue = 0;
+    this->hasDeadline = false;
+    this->isStopped = false;
+    this->nodesSinceClockCheck = 0;
 }
 
 Algorithm::~Algorithm()
@@ -28,19 +53,49 @@ Algorithm::Algorithm(int evalVersion, int maxDepth, Player callingPlayer)
     this->minimaxExpandedNodes = 0;
     this->absearchLeafNodes = 0;
     this->absearchExpandedNodes = 0;
+    this->piecesGenerated = 0;
+    this->piecesToGenerate = 0;
+    this->collapseDuplicateCaptures = false;
+    this->tableProbes = 0;
+    this->tableHits = 0;
+    this->tableCutoffs = 0;
+    this->orderMoves = true;
+    this->nullWindows = true;
+    this->nullWindowResearches = 0;
+    this->betaCutoffs = 0;
+    this->firstMoveCutoffs = 0;
+    this->useQuiescence = true;
+    this->quiescenceNodes = 0;
+    this->reduceLateMoves = true;
+    this->lateMoveReductions = 0;
+    this->lateMoveResearches = 0;
+    this->aspirationWindow = 0;
+    this->aspirationFailLows = 0;
+    this->aspirationFailHighs = 0;
+    this->hasExpectedValue = false;
+    this->expectedValue = 0;
+    this->hasDeadline = false;
+    this->isStopped = false;
+    this->nodesSinceClockCheck = 0;
+    this->aspirationWindow = getDefaultAspirationWindow(evalVersion);
+
+    // an Algorithm is made for each search, so this is where a new search starts
+    this->transpositionTable = this->callingPlayer.getTranspositionTable();
+    if (this->transpositionTable)
+        this->transpositionTable->newSearch();
 }
 
 /**
- * movegen function gets a list of all possible moves for a player as a vector of moves.
+ * movegen function gets a list of all possible moves for a player as a list of moves.
  * This function is essentially a wrapper, which calls the movegen function in class Board. 
  * @author Borislav Sabotinov
  * 
  * @param Board board 
  * @param Player board
  * 
- * @return vector<Board::Move> listofPossibleMoves
+ * @return Board::MoveList listofPossibleMoves
  */
-std::vector<Board::Move> Algorithm::movegen(Board board, Color color)
+Board::MoveList Algorithm::movegen(Board &board, Color color)
 {
     return board.moveGen(color);
 }
@@ -61,7 +116,7 @@ std::vector<Board::Move> Algorithm::movegen(Board board, Color color)
  * @return int	        :			Returns an evaluated score for the board.
  *
  */
-int Algorithm::evalFunctOne(Board state, Color color)
+int Algorithm::evalFunctOne(Board &state, Color color)
 {
     int gameTurn = callingPlayer.getNumTurns();
     int finalScore = 0;
@@ -86,8 +141,8 @@ int Algorithm::evalFunctOne(Board state, Color color)
     int opponentBackRowDefenseWeight = 2;
     int opponentScore = 0;
     int opponentBonus = 0;
-    std::vector<Board::Move> playerMoves;
-    std::vector<Board::Move> opponentMoves;
+    Board::MoveList playerMoves;
+    Board::MoveList opponentMoves;
     //=======================================================================
     // Set up a few items based on the player color. Opponent and player
     // defense row.
@@ -167,7 +222,7 @@ int Algorithm::evalFunctOne(Board state, Color color)
         // Games tend to run a little longer, so the tunr numbers are set up
         // higher than one would expect.
         //=======================================================================
-        if (gameTurn >= 40)
+        if (gameTurn >= EVAL_ONE_ENDGAME_TURN)
         {
             manWeight = 20;
             kingWeight = 80;
@@ -301,7 +356,7 @@ int Algorithm::evalFunctOne(Board state, Color color)
  * 
  * @return an integer score of how good we think the state is
  */
-int Algorithm::evalFunctTwo(Board state, Color color)
+int Algorithm::evalFunctTwo(Board &state, Color color)
 {
     const int KING = 2,
               MAN = 1;
@@ -508,7 +563,7 @@ int Algorithm::evalFunctTwo(Board state, Color color)
  * 
  * @return an integer score of how good we think the state is
  */
-int Algorithm::evalFunctThree(Board state, Color color)
+int Algorithm::evalFunctThree(Board &state, Color color)
 {
     /*  Declaration of "boards" with a weight for each square
         Two for regular pieces of each color and two for kings of each color
@@ -546,7 +601,7 @@ int Algorithm::evalFunctThree(Board state, Color color)
                                  5, 5, 5, 10,
                                  1, 1, 1, 1};
 
-    std::string colorTxt = (color == Color::RED) ? " (RED is Friendly) " : " (BLACK is Friendly) ";
+    const char *colorTxt = (color == Color::RED) ? " (RED is Friendly) " : " (BLACK is Friendly) ";
     // KING has 4 moves max, so value is 4; MAN has 2 moves max so values is 2
     const int KING = 2, MAN = 1, KING_VALUE = 4, MAN_VALUE = 2;
 
@@ -576,16 +631,14 @@ int Algorithm::evalFunctThree(Board state, Color color)
 
     int casualtyScore = 0, captureScore = 0, positionScore = 0, playerPiece = 0, enemyPiece = 0, advancementScore = 0;
 
-    std::vector<Board::Move> playerMoves = state.moveGen(color);
-    std::vector<Board::Move> enemyMoves = state.moveGen(switchPlayerColor(color));
-
-    Pieces playerPieces = state.getPlayerPieces(color);
-    Pieces opponentPieces = state.getOpponentPieces(color);
-    Pieces *p_playerPieces = &playerPieces;
-    Pieces *p_opponentPieces = &opponentPieces;
+    // CHECK TERMINAL STATE
+    if (!state.hasAnyMove(switchPlayerColor(color)))
+        return 7999999; // good for us if enemy has no moves left!
+    else if (!state.hasAnyMove(color))
+        return -7999999; // bad for us if we're out of moves!
 
-    std::vector<Board::Move> playerJumpsForPiece;
-    std::vector<Board::Move> opponentJumpsForPiece;
+    Board::MoveList playerMoves = state.moveGen(color);
+    Board::MoveList enemyMoves = state.moveGen(switchPlayerColor(color));
 
     // helper values to quickly check if a piece is in a certain notable location
     // back rows for each color player to determine KING-ing
@@ -594,12 +647,6 @@ int Algorithm::evalFunctThree(Board state, Color color)
     const long long blackBackRowGrp = (1LL << 29) | (1LL << 30) | (1LL << 31) | (1LL << 32);
     const long long sideColumnGrp = (1LL << 5) | (1LL << 13) | (1LL << 21) | (1LL << 12) | (1LL << 20) | (1LL << 28);
 
-    // CHECK TERMINAL STATE
-    if (enemyMoves.size() == 0)
-        return 7999999; // good for us if enemy has no moves left!
-    else if (playerMoves.size() == 0)
-        return -7999999; // bad for us if we're out of moves!
-
     // MAIN LOOP FOR SCORING POSITION
     for (int piece = 0; piece < 32; piece++)
     {
@@ -652,21 +699,23 @@ int Algorithm::evalFunctThree(Board state, Color color)
                 captureScore += 200;
 
             int destSqr = playerMoves.at(i).destinationSquare.back();
-            std::vector<int> adjMoves = state.boardMoveTable[destSqr].moves;
+            // squares one step from where we land, lowest square first
+            uint32_t adjMoves = state.boardMoveTable[destSqr].moveMask;
 
             if (color == Color::RED)
             {
-                for (int j = 0; j < adjMoves.size(); j++)
+                for (uint32_t adjSquares = adjMoves; adjSquares != 0; adjSquares &= adjSquares - 1)
                 {
-                    if (adjMoves.at(j) > destSqr) // check enemy MEN and KING below
+                    int adjSqr = __builtin_ctz(adjSquares) + 1;
+                    if (adjSqr > destSqr) // check enemy MEN and KING below
                     {
-                        int enemyPiece = state.getPieceInSquare(adjMoves.at(j), switchPlayerColor(color));
+                        int enemyPiece = state.getPieceInSquare(adjSqr, switchPlayerColor(color));
                         if (enemyPiece == MAN || enemyPiece == KING)
                             captureScore -= 100; // not safe
                     }
-                    else if (adjMoves.at(j) < destSqr) // we're red, anyting above us can only capture if enemy KING
+                    else if (adjSqr < destSqr) // we're red, anyting above us can only capture if enemy KING
                     {
-                        int enemyPiece = state.getPieceInSquare(adjMoves.at(j), switchPlayerColor(color));
+                        int enemyPiece = state.getPieceInSquare(adjSqr, switchPlayerColor(color));
                         if (enemyPiece == KING)
                             captureScore -= 100; // not safe
                     }
@@ -676,17 +725,18 @@ int Algorithm::evalFunctThree(Board state, Color color)
             }
             else
             {
-                for (int j = 0; j < adjMoves.size(); j++)
+                for (uint32_t adjSquares = adjMoves; adjSquares != 0; adjSquares &= adjSquares - 1)
                 {
-                    if (adjMoves.at(j) < destSqr) // check enemy MEN and KING above
+                    int adjSqr = __builtin_ctz(adjSquares) + 1;
+                    if (adjSqr < destSqr) // check enemy MEN and KING above
                     {
-                        int enemyPiece = state.getPieceInSquare(adjMoves.at(j), switchPlayerColor(color));
+                        int enemyPiece = state.getPieceInSquare(adjSqr, switchPlayerColor(color));
                         if (enemyPiece == MAN || enemyPiece == KING)
                             captureScore -= 100; // not safe
                     }
-                    else if (adjMoves.at(j) > destSqr) // we're black, anyting below us can only capture if enemy KING
+                    else if (adjSqr > destSqr) // we're black, anyting below us can only capture if enemy KING
                     {
-                        int enemyPiece = state.getPieceInSquare(adjMoves.at(j), switchPlayerColor(color));
+                        int enemyPiece = state.getPieceInSquare(adjSqr, switchPlayerColor(color));
                         if (enemyPiece == KING)
                             captureScore -= 100; // not safe
                     }
@@ -721,7 +771,8 @@ int Algorithm::evalFunctThree(Board state, Color color)
             else if (capturedPieceType == MAN) // we lose one MAN
             {
                 int opponentDestinationSqr = enemyMoves.at(j).destinationSquare.at(0);
-                std::vector<int> adjMoves = state.boardMoveTable[opponentDestinationSqr].moves;
+                // squares one step from where the enemy lands, lowest square first
+                uint32_t adjMoves = state.boardMoveTable[opponentDestinationSqr].moveMask;
 
                 if (color == Color::RED)
                 {
@@ -739,17 +790,18 @@ int Algorithm::evalFunctThree(Board state, Color color)
                     {
                         // if (diffInNumMen >= 1)
                         // {
-                        for (int j = 0; j < adjMoves.size(); j++)
+                        for (uint32_t adjSquares = adjMoves; adjSquares != 0; adjSquares &= adjSquares - 1)
                         {
-                            int ourPiece = state.getPieceInSquare(adjMoves.at(j), switchPlayerColor(color));
+                            int adjSqr = __builtin_ctz(adjSquares) + 1;
+                            int ourPiece = state.getPieceInSquare(adjSqr, switchPlayerColor(color));
                             // check if we have a king below; we're red, only our king can go upwards
-                            if (adjMoves.at(j) > opponentDestinationSqr)
+                            if (adjSqr > opponentDestinationSqr)
                             {
                                 if (ourPiece == KING)
                                     captureScore += 1000; // can retaliate
                             }
                             // we're red, we can retaliate with MAN or KING if enemy is above
-                            else if (adjMoves.at(j) < opponentDestinationSqr)
+                            else if (adjSqr < opponentDestinationSqr)
                             {
                                 if (ourPiece == MAN || ourPiece == KING)
                                     captureScore += 1000; // can retaliate
@@ -778,16 +830,17 @@ int Algorithm::evalFunctThree(Board state, Color color)
                     {
                         // if (numPlayerTotalPieces >= numEnemyTotalPieces)
                         // {
-                        for (int j = 0; j < adjMoves.size(); j++)
+                        for (uint32_t adjSquares = adjMoves; adjSquares != 0; adjSquares &= adjSquares - 1)
                         {
-                            int ourPiece = state.getPieceInSquare(adjMoves.at(j), switchPlayerColor(color));
-                            if (adjMoves.at(j) < opponentDestinationSqr) // check our KING above
+                            int adjSqr = __builtin_ctz(adjSquares) + 1;
+                            int ourPiece = state.getPieceInSquare(adjSqr, switchPlayerColor(color));
+                            if (adjSqr < opponentDestinationSqr) // check our KING above
                             {
                                 if (ourPiece == KING)
                                     captureScore += 1000; // can retaliate
                             }
                             // we're black, if enemy is below we can retaliate with MAN or KING
-                            else if (adjMoves.at(j) > opponentDestinationSqr)
+                            else if (adjSqr > opponentDestinationSqr)
                             {
                                 if (ourPiece == MAN || ourPiece == KING)
                                     captureScore += 1000; // can retaliate
@@ -817,7 +870,7 @@ int Algorithm::evalFunctThree(Board state, Color color)
  * 
  * @return a Result struct, which consists of a value and a move. 
  */
-int Algorithm::staticEval(Board state, Color color, int evalVersion)
+int Algorithm::staticEval(Board &state, Color color, int evalVersion)
 {
     int scoreOfGoodness;
 
@@ -862,7 +915,7 @@ bool Algorithm::deepEnough(int currentDepth)
  * minimax algorithm returns the position of the best move
  * @author Randall Henderson
  * 
- * @param Board board
+ * @param Board &state - moves are made and taken back on it in place; it is unchanged on return
  * @param int depth
  * @param Color color
  * @param int passThresh = 9000000
@@ -871,28 +924,49 @@ bool Algorithm::deepEnough(int currentDepth)
  * @return a Result struct, which consists of a value and a Move
  */
 
-Algorithm::Result Algorithm::minimax_a_b(Board state, int depth, Color color, int useThresh, int passThresh)
+Algorithm::Result Algorithm::minimax_a_b(Board &state, int depth, Color color, int useThresh, int passThresh)
 {
-    Algorithm::Result result; // Return structure for MiniMaxAB
+    // the color is decided once per ply, the node itself is compiled per color
+    if (color == Color::RED)
+        return minimax_a_b<Color::RED>(state, depth, 0, useThresh, passThresh);
+    else
+        return minimax_a_b<Color::BLACK>(state, depth, 0, useThresh, passThresh);
+}
+
+template <Color color>
+Algorithm::Result Algorithm::minimax_a_b(Board &state, int depth, int ply, int useThresh, int passThresh)
+{
+    Algorithm::Result result = {0, Board::PackedMove()}; // Return structure for MiniMaxAB
     std::string indentValue;  // Tracking header in cout statments.  Shows level in recursion
     std::string playerColor;  // Used for debugging ouput
-    Board::Move bestPath;     // best move struct - starts as a null move
+    Board::PackedMove bestPath; // best move - starts as a null move
     int newValue;
 
-    if (color == Color::RED)
+    if (isOutOfTime())
     {
-        playerColor = Pieces::ANSII_RED_START;
-        playerColor.append("  RED ");
-        playerColor.append(Pieces::ANSII_END);
+        result.value = 0;
+        return result;
     }
-    else
+
+    // The tracking header is only built when it will be printed, so that a quiet
+    // search does not allocate a string at every node.
+    if (Pieces::ouputDebugData)
     {
-        playerColor = "BLACK ";
-    }
+        if (color == Color::RED)
+        {
+            playerColor = Pieces::ANSII_RED_START;
+            playerColor.append("  RED ");
+            playerColor.append(Pieces::ANSII_END);
+        }
+        else
+        {
+            playerColor = "BLACK ";
+        }
 
-    indentValue = playerColor;
+        indentValue = playerColor;
 
-    indentValue.append("1.");
+        indentValue.append("1.");
+    }
 
     //   Debug code for values passed into the function
     if (Pieces::ouputDebugData > 0 && depth == 0)
@@ -900,15 +974,20 @@ Algorithm::Result Algorithm::minimax_a_b(Board state, int depth, Color color, in
                   << " Depth-> " << depth << " useThresh-> " << useThresh << " passThresh-> " << passThresh
                   << Pieces::ANSII_END << std::endl;
 
-    indentValue.append("2.");
+    if (Pieces::ouputDebugData)
+        indentValue.append("2.");
 
     if (deepEnough(depth)) // deep enough and Terminal could be combined.  Separated for error tracking
     {
-        result.value = staticEval(state, color, evalVersion);
+        // the value is negated below for the other player, so its window is too
+        if (callingPlayer.getColor() != color)
+            result.value = horizonValue<color>(state, ply, -useThresh, -passThresh);
+        else
+            result.value = horizonValue<color>(state, ply, passThresh, useThresh);
 
         if (Pieces::ouputDebugData > 0)
             std::cout << indentValue << Pieces::ANSII_RED_COUT << "Deep Enough, Move Evaluated.  Returning -> "
-                      << result.value << " Bestmove destination size " << result.bestMove.destinationSquare.size() << Pieces::ANSII_END << std::endl;
+                      << result.value << " Bestmove is null " << result.bestMove.isNull() << Pieces::ANSII_END << std::endl;
 
         minimaxLeafNodes++;
 
@@ -919,12 +998,24 @@ Algorithm::Result Algorithm::minimax_a_b(Board state, int depth, Color color, in
         return result;
     }
 
-    indentValue.append("3.");
+    if (Pieces::ouputDebugData)
+        indentValue.append("3.");
+
+    uint64_t key = state.getHashKey();
+    int passThreshAtEntry = passThresh;
 
-    std::vector<Board::Move> successors = movegen(state, color);
+    Board::PackedMove hashMove;
+
+    if (probeTable(key, depth, passThresh, useThresh, result, hashMove))
+        return result;
+
+    // Successors are built as they are tried, so a cutoff skips the rest of the generation
+    MovePicker<color> successors(state, collapseDuplicateCaptures, orderMoves ? &moveOrdering : NULL, hashMove, ply);
+    Board::PackedMove successor;
+    int successorIndex = 0;
 
     //  Current Player has no moves.  This is the equivalent to deep enough or terminal move
-    if (successors.size() == 0)
+    if (successors.getStage() == MovePicker<color>::DONE)
     {
         result.value = staticEval(state, color, evalVersion);
 
@@ -941,28 +1032,33 @@ Algorithm::Result Algorithm::minimax_a_b(Board state, int depth, Color color, in
         return result;
     }
 
-    for (int successorIndex = 0; successorIndex < successors.size(); successorIndex++)
+    while (successors.nextMove(successor))
     {
-        //Create a board at the current iteration of successors
-        Board tmpState = state.updateBoard(successors.at(successorIndex), color);
+        // Apply the current successor to the board; it is taken back after the recursive call
+        Board::Undo undo;
+        state.makeMove<color>(successor, undo);
 
         minimaxExpandedNodes++;
+        successorIndex++;
 
-        indentValue.append(">.");
+        if (Pieces::ouputDebugData)
+            indentValue.append(">.");
 
         if (Pieces::ouputDebugData)
-            std::cout << indentValue << Pieces::ANSII_BLUE_COUT << "Checking Moves:  Move #-> " << successorIndex + 1
-                      << " Passed in parameters:  Start-> " << successors.at(successorIndex).startSquare << " Move to-> "
-                      << successors.at(successorIndex).destinationSquare.back() << " Depth-> " << depth
+            std::cout << indentValue << Pieces::ANSII_BLUE_COUT << "Checking Moves:  Move #-> " << successorIndex
+                      << " Passed in parameters:  Start-> " << successor.getStartSquare() << " Move to-> "
+                      << successor.getEndSquare() << " Depth-> " << depth
                       << Pieces::ANSII_END << std::endl;
 
         // recursive call
-        Result resultSucc = minimax_a_b(tmpState, depth - 1, switchPlayerColor(color), -passThresh, -useThresh);
+        Result resultSucc = minimax_a_b<Board::getOpponentColor(color)>(state, depth - 1, ply + 1, -passThresh, -useThresh);
+
+        state.unmakeMove<color>(successor, undo);
 
         if (Pieces::ouputDebugData)
             std::cout << indentValue << Pieces::ANSII_GREEN_START << "Recursive Return:  Just checked-> "
-                      << successors.at(successorIndex).startSquare << " -> "
-                      << successors.at(successorIndex).destinationSquare.back()
+                      << successor.getStartSquare() << " -> "
+                      << successor.getEndSquare()
                       << " New Value-> " << resultSucc.value << " Depth-> "
                       << depth << " useThresh-> " << useThresh << " passThresh-> " << passThresh
                       << Pieces::ANSII_END << std::endl;
@@ -972,13 +1068,13 @@ Algorithm::Result Algorithm::minimax_a_b(Board state, int depth, Color color, in
         if (newValue > passThresh) // Found the Best Move
         {
             if (Pieces::ouputDebugData > 0 && depth == this->maxDepth)
-                std::cout << indentValue << Pieces::ANSII_YELLOW_COUT << "New Best Move.  From-> " << successors.at(successorIndex).startSquare
-                          << " to-> " << successors.at(successorIndex).destinationSquare.back()
+                std::cout << indentValue << Pieces::ANSII_YELLOW_COUT << "New Best Move.  From-> " << successor.getStartSquare()
+                          << " to-> " << successor.getEndSquare()
                           << " Change PassThresh  Old: " << passThresh
                           << " to  New: " << newValue << Pieces::ANSII_END << std::endl;
 
             passThresh = newValue;
-            bestPath = successors.at(successorIndex);
+            bestPath = successor;
         }
 
         if (passThresh >= useThresh) // Best move on the branch.  No need to look anymore
@@ -987,15 +1083,22 @@ Algorithm::Result Algorithm::minimax_a_b(Board state, int depth, Color color, in
                 std::cout << indentValue << Pieces::ANSII_YELLOW_COUT << "AB-CUTOFF!!  Best Move on the Branch.  PassThresh -> "
                           << Pieces::ANSII_END << passThresh << " UseThresh-> " << useThresh << " Returning " << std::endl;
 
+            countGeneratedPieces(successors);
+            recordCutoff(color, successor, ply, depth, successorIndex);
             result.value = passThresh;
-            result.bestMove = successors.at(successorIndex);
+            result.bestMove = successor;
 
+            storeTable(key, depth, passThreshAtEntry, useThresh, result);
             return result;
         }
     }
 
+    countGeneratedPieces(successors);
+
     result.value = passThresh;
     result.bestMove = bestPath;
+
+    storeTable(key, depth, passThreshAtEntry, useThresh, result);
     return result;
 }
 
@@ -1003,7 +1106,7 @@ Algorithm::Result Algorithm::minimax_a_b(Board state, int depth, Color color, in
  * Alpha Beta Search
  * @author Borislav Sabotinov
  * 
- * @param Board state
+ * @param Board state - copied once; the whole search then makes and takes back moves on this copy
  * 
  * @return a Result struct, which consists of a value and a Move
  */
@@ -1019,10 +1122,71 @@ Algorithm::Result Algorithm::alphaBetaSearch(Board state)
             std::cout << "In alphaBetaSearch...." << std::endl;
     }
 
-    int alpha = std::numeric_limits<int>::min(); // tracks best value for max, initialized to WORST case
-    int beta = std::numeric_limits<int>::max();  // tracks best value for min, initialized to WORST case
+    return searchRoot(state, false);
+}
+
+/**
+ * searchRoot runs the root search of alphaBetaSearch or principalVariationSearch. Without an
+ * expected value it uses the widest window. With one, it first searches a window of
+ * aspirationWindow either side of it, which prunes more. A score on or outside the window only
+ * bounds the true score, so that side of the window is widened by ASPIRATION_WIDENING around the
+ * score found and the root searched again, until the score falls inside. After
+ * ASPIRATION_MAX_RESEARCHES widenings the failing side is opened all the way.
+ *
+ * @param Board &state - the root position; moves are made and taken back on it in place
+ * @param bool isNegamax - true for principalVariationSearch, false for alphaBetaSearch
+ *
+ * @return the Result of the last root search
+ */
+Algorithm::Result Algorithm::searchRoot(Board &state, bool isNegamax)
+{
+    // tracks best value for max, initialized to WORST case; negamax must be able to negate it
+    const long long lowest = isNegamax ? -std::numeric_limits<int>::max() : std::numeric_limits<int>::min();
+    const long long highest = std::numeric_limits<int>::max();
+
+    long long alpha = lowest, beta = highest;
+    long long lowDelta = aspirationWindow, highDelta = aspirationWindow;
+    int numResearches = 0;
+
+    if (hasExpectedValue && aspirationWindow > 0)
+    {
+        alpha = std::max(lowest, (long long)expectedValue - lowDelta);
+        beta = std::min(highest, (long long)expectedValue + highDelta);
+    }
+
+    while (true)
+    {
+        Result result;
+
+        if (!isNegamax)
+            result = maxValue(state, maxDepth, (int)alpha, (int)beta, callingPlayer.getColor());
+        else if (callingPlayer.getColor() == Color::RED)
+            result = pvsValue<Color::RED>(state, maxDepth, 0, (int)alpha, (int)beta);
+        else
+            result = pvsValue<Color::BLACK>(state, maxDepth, 0, (int)alpha, (int)beta);
+
+        if (isStopped)
+            return result;
+
+        numResearches++;
 
-    return maxValue(state, maxDepth, alpha, beta, callingPlayer.getColor());
+        if (result.value <= alpha && alpha > lowest)
+        {
+            aspirationFailLows++;
+            lowDelta *= ASPIRATION_WIDENING;
+            alpha = (numResearches > ASPIRATION_MAX_RESEARCHES) ? lowest : std::max(lowest, result.value - lowDelta);
+        }
+        else if (result.value >= beta && beta < highest)
+        {
+            aspirationFailHighs++;
+            highDelta *= ASPIRATION_WIDENING;
+            beta = (numResearches > ASPIRATION_MAX_RESEARCHES) ? highest : std::min(highest, result.value + highDelta);
+        }
+        else
+        {
+            return result;
+        }
+    }
 }
 
 /**
@@ -1031,13 +1195,23 @@ Algorithm::Result Algorithm::alphaBetaSearch(Board state)
  * There is indirect recursion as MAX calls MIN, which calls MAX again and so on.  
  * @author Borislav Sabotinov
  * 
- * @param Board state
+ * @param Board &state - moves are made and taken back on it in place
  * @param int alpha
  * @param int beta
  * 
  * @return int utilityValue
  */
-Algorithm::Result Algorithm::maxValue(Board state, int depth, int alpha, int beta, Color color)
+Algorithm::Result Algorithm::maxValue(Board &state, int depth, int alpha, int beta, Color color)
+{
+    // the color is decided once per ply, the node itself is compiled per color
+    if (color == Color::RED)
+        return maxValue<Color::RED>(state, depth, 0, alpha, beta);
+    else
+        return maxValue<Color::BLACK>(state, depth, 0, alpha, beta);
+}
+
+template <Color color>
+Algorithm::Result Algorithm::maxValue(Board &state, int depth, int ply, int alpha, int beta)
 {
     if (Pieces::ouputDebugData)
     {
@@ -1049,19 +1223,36 @@ Algorithm::Result Algorithm::maxValue(Board state, int depth, int alpha, int bet
     }
 
     Algorithm::Result result;
-    Board::Move bestMove;
+    Board::PackedMove bestMove;
+
+    if (isOutOfTime())
+    {
+        result.value = 0;
+        return result;
+    }
 
     if (deepEnough(depth))
     {
         absearchLeafNodes++;
-        result.value = staticEval(state, color, evalVersion);
+        result.value = horizonValue<color>(state, ply, alpha, beta);
         return result;
     }
 
-    std::vector<Board::Move> listOfActions = actions(state, color);
+    uint64_t key = state.getHashKey();
+    int alphaAtEntry = alpha;
+
+    Board::PackedMove hashMove;
+
+    if (probeTable(key, depth, alpha, beta, result, hashMove))
+        return result;
+
+    // moves are built as they are tried, best guess first, so a cutoff skips the rest of the generation
+    MovePicker<color> picker(state, collapseDuplicateCaptures, orderMoves ? &moveOrdering : NULL, hashMove, ply);
+    Board::PackedMove action;
+    int numMovesTried = 0;
 
     // terminal check
-    if (listOfActions.size() == 0)
+    if (picker.getStage() == MovePicker<color>::DONE)
     {
         absearchLeafNodes++;
         result.value = staticEval(state, color, evalVersion); // eval acts as utility funct
@@ -1073,36 +1264,61 @@ Algorithm::Result Algorithm::maxValue(Board state, int depth, int alpha, int bet
 
     result.value = std::numeric_limits<int>::min();
 
-    for (int actionIndex = 0; actionIndex < listOfActions.size(); actionIndex++)
+    while (picker.nextMove(action))
     {
-        Player::printMove(listOfActions.at(actionIndex), color, false);
+        if (Pieces::ouputDebugData)
+            Player::printMove(state.unpackMove(action, color), color, false);
         absearchExpandedNodes++;
-        Board tmpState = state.updateBoard(listOfActions.at(actionIndex), color);
-        Algorithm::Result minValueResult = minValue(tmpState, depth - 1, alpha, beta, switchPlayerColor(color));
+        numMovesTried++;
+        Board::Undo undo;
+        state.makeMove<color>(action, undo);
+        Algorithm::Result minValueResult;
+        int reduction = getLateMoveReduction(depth, numMovesTried, action);
+        bool searchFull = true;
+
+        // a reduced move only has to show it is no better than alpha; if it might be, search it in full
+        if (reduction > 0)
+        {
+            lateMoveReductions++;
+            minValueResult = minValue<Board::getOpponentColor(color)>(state, depth - 1 - reduction, ply + 1, alpha, alpha + 1);
+            searchFull = minValueResult.value > alpha;
+
+            if (searchFull)
+                lateMoveResearches++;
+        }
+
+        if (searchFull)
+            minValueResult = minValue<Board::getOpponentColor(color)>(state, depth - 1, ply + 1, alpha, beta);
+        state.unmakeMove<color>(action, undo);
 
         if (minValueResult.value > result.value) // Best move located
         {
             result.value = minValueResult.value;
-            bestMove = listOfActions.at(actionIndex);
+            bestMove = action;
         }
 
         if (result.value >= beta) // no need to examine branch
         {
-            result.bestMove = listOfActions.at(actionIndex);
+            countGeneratedPieces(picker);
+            recordCutoff(color, action, ply, depth, numMovesTried);
+            result.bestMove = action;
+            storeTable(key, depth, alphaAtEntry, beta, result);
             return result;
         }
 
         alpha = std::max(alpha, result.value);
     }
 
+    countGeneratedPieces(picker);
+
     if (Pieces::ouputDebugData)
     {
-        std::cout << "alpha: " << alpha << " beta: " << beta << " val: " << result.value << " move start: " << result.bestMove.startSquare << std::endl;
-        for (int i = 0; i < result.bestMove.destinationSquare.size(); i++)
-            std::cout << "dest: " << result.bestMove.destinationSquare.at(i) << std::endl;
+        std::cout << "alpha: " << alpha << " beta: " << beta << " val: " << result.value << " move start: " << result.bestMove.getStartSquare() << std::endl;
+        std::cout << "dest: " << result.bestMove.getEndSquare() << std::endl;
     }
 
     result.bestMove = bestMove;
+    storeTable(key, depth, alphaAtEntry, beta, result);
     return result;
 }
 
@@ -1112,13 +1328,23 @@ Algorithm::Result Algorithm::maxValue(Board state, int depth, int alpha, int bet
  * There is indirect recursion as MAX calls MIN, which calls MAX again and so on. 
  * @author Borislav Sabotinov
  * 
- * @param Board state
+ * @param Board &state - moves are made and taken back on it in place
  * @param int alpha
  * @param int beta
  * 
- * @return Result structure, which contains a value score and a Board::Move bestMove structure
+ * @return Result structure, which contains a value score and a Board::PackedMove bestMove
  */
-Algorithm::Result Algorithm::minValue(Board state, int depth, int alpha, int beta, Color color)
+Algorithm::Result Algorithm::minValue(Board &state, int depth, int alpha, int beta, Color color)
+{
+    // the color is decided once per ply, the node itself is compiled per color
+    if (color == Color::RED)
+        return minValue<Color::RED>(state, depth, 0, alpha, beta);
+    else
+        return minValue<Color::BLACK>(state, depth, 0, alpha, beta);
+}
+
+template <Color color>
+Algorithm::Result Algorithm::minValue(Board &state, int depth, int ply, int alpha, int beta)
 {
     if (Pieces::ouputDebugData)
     {
@@ -1130,19 +1356,36 @@ Algorithm::Result Algorithm::minValue(Board state, int depth, int alpha, int bet
     }
 
     Result result;
-    Board::Move bestMove;
+    Board::PackedMove bestMove;
+
+    if (isOutOfTime())
+    {
+        result.value = 0;
+        return result;
+    }
 
     if (deepEnough(depth))
     {
         absearchLeafNodes++;
-        result.value = staticEval(state, color, evalVersion);
+        result.value = horizonValue<color>(state, ply, alpha, beta);
         return result;
     }
 
-    std::vector<Board::Move> listOfActions = actions(state, color);
+    uint64_t key = state.getHashKey();
+    int betaAtEntry = beta;
+
+    Board::PackedMove hashMove;
+
+    if (probeTable(key, depth, alpha, beta, result, hashMove))
+        return result;
+
+    // moves are built as they are tried, best guess first, so a cutoff skips the rest of the generation
+    MovePicker<color> picker(state, collapseDuplicateCaptures, orderMoves ? &moveOrdering : NULL, hashMove, ply);
+    Board::PackedMove action;
+    int numMovesTried = 0;
 
     // terminal check
-    if (listOfActions.size() == 0)
+    if (picker.getStage() == MovePicker<color>::DONE)
     {
         absearchLeafNodes++;
         result.value = staticEval(state, color, evalVersion); // eval acts as utility funct
@@ -1154,39 +1397,329 @@ Algorithm::Result Algorithm::minValue(Board state, int depth, int alpha, int bet
 
     result.value = std::numeric_limits<int>::max();
 
-    for (int actionIndex = 0; actionIndex < listOfActions.size(); actionIndex++)
+    while (picker.nextMove(action))
     {
-        Player::printMove(listOfActions.at(actionIndex), color, false);
+        if (Pieces::ouputDebugData)
+            Player::printMove(state.unpackMove(action, color), color, false);
         absearchExpandedNodes++;
-        Board tmpState = state.updateBoard(listOfActions.at(actionIndex), color);
-        Result maxValueResult = maxValue(tmpState, depth - 1, alpha, beta, switchPlayerColor(color));
+        numMovesTried++;
+        Board::Undo undo;
+        state.makeMove<color>(action, undo);
+        Result maxValueResult;
+        int reduction = getLateMoveReduction(depth, numMovesTried, action);
+        bool searchFull = true;
+
+        // a reduced move only has to show it is no better than beta; if it might be, search it in full
+        if (reduction > 0)
+        {
+            lateMoveReductions++;
+            maxValueResult = maxValue<Board::getOpponentColor(color)>(state, depth - 1 - reduction, ply + 1, beta - 1, beta);
+            searchFull = maxValueResult.value < beta;
+
+            if (searchFull)
+                lateMoveResearches++;
+        }
+
+        if (searchFull)
+            maxValueResult = maxValue<Board::getOpponentColor(color)>(state, depth - 1, ply + 1, alpha, beta);
+        state.unmakeMove<color>(action, undo);
 
         if (maxValueResult.value < result.value) // Best move located
         {
             result.value = maxValueResult.value;
-            bestMove = listOfActions.at(actionIndex);
+            bestMove = action;
         }
 
         if (result.value <= alpha)
         {
-            result.bestMove = listOfActions.at(actionIndex);
+            countGeneratedPieces(picker);
+            recordCutoff(color, action, ply, depth, numMovesTried);
+            result.bestMove = action;
+            storeTable(key, depth, alpha, betaAtEntry, result);
             return result;
         }
 
         beta = std::min(beta, result.value);
     }
 
+    countGeneratedPieces(picker);
+
     if (Pieces::ouputDebugData)
     {
-        std::cout << "alpha: " << alpha << " beta: " << beta << " val: " << result.value << " move start: " << result.bestMove.startSquare << std::endl;
-        for (int i = 0; i < result.bestMove.destinationSquare.size(); i++)
-            std::cout << "dest: " << result.bestMove.destinationSquare.at(i) << std::endl;
+        std::cout << "alpha: " << alpha << " beta: " << beta << " val: " << result.value << " move start: " << result.bestMove.getStartSquare() << std::endl;
+        std::cout << "dest: " << result.bestMove.getEndSquare() << std::endl;
+    }
+
+    result.bestMove = bestMove;
+    storeTable(key, depth, alpha, betaAtEntry, result);
+    return result;
+}
+
+/**
+ * Principal Variation Search, a negamax alpha-beta. With good move ordering the first move of a
+ * node is usually its best, so it is searched with the full window and every later move with a
+ * null window (alpha, alpha + 1), which only asks whether the move is better than alpha and
+ * prunes more. A move that fails high inside the window is searched again with the full window
+ * for its true score, so PVS only saves nodes while the first move really is the best one most of
+ * the time. That holds when iterative deepening has left hash moves in the table; a single search
+ * with an empty table can do worse than alphaBetaSearch, see Benchmark::runPrincipalVariation.
+ *
+ * Scores are negamax: every node scores the position for the player to move there, and a child's
+ * score is negated. Unlike maxValue and minValue, a search of odd depth still ends on scores for
+ * the calling player.
+ *
+ * @param Board state - copied once; the whole search then makes and takes back moves on this copy
+ *
+ * @return a Result struct, which consists of a value and a Move
+ */
+Algorithm::Result Algorithm::principalVariationSearch(Board state)
+{
+    return searchRoot(state, true);
+}
+
+/**
+ * pvsValue searches one node of principalVariationSearch. Leaves and nodes are counted with the
+ * Alpha-Beta counts.
+ *
+ * @param Board &state - moves are made and taken back on it in place
+ * @param int depth - the plies left to search
+ * @param int ply - how many plies the node is below the root
+ * @param int alpha, beta - the window, for the player to move
+ *
+ * @return Result structure, with the score for the player to move and the best move
+ */
+template <Color color>
+Algorithm::Result Algorithm::pvsValue(Board &state, int depth, int ply, int alpha, int beta)
+{
+    Result result;
+    Board::PackedMove bestMove;
+
+    if (isOutOfTime())
+    {
+        result.value = 0;
+        return result;
+    }
+
+    if (deepEnough(depth))
+    {
+        absearchLeafNodes++;
+        result.value = horizonValue<color>(state, ply, alpha, beta);
+        return result;
+    }
+
+    uint64_t key = state.getHashKey();
+    int alphaAtEntry = alpha;
+    Board::PackedMove hashMove;
+
+    if (probeTable(key, depth, alpha, beta, result, hashMove))
+        return result;
+
+    MovePicker<color> picker(state, collapseDuplicateCaptures, orderMoves ? &moveOrdering : NULL, hashMove, ply);
+    Board::PackedMove action;
+    int numMovesTried = 0;
+
+    // terminal check
+    if (picker.getStage() == MovePicker<color>::DONE)
+    {
+        absearchLeafNodes++;
+        result.value = staticEval(state, color, evalVersion);
+        return result;
+    }
+
+    result.value = -std::numeric_limits<int>::max();
+
+    while (picker.nextMove(action))
+    {
+        absearchExpandedNodes++;
+        numMovesTried++;
+        Board::Undo undo;
+        state.makeMove<color>(action, undo);
+
+        int value;
+
+        if (numMovesTried == 1 || !nullWindows)
+        {
+            value = -pvsValue<Board::getOpponentColor(color)>(state, depth - 1, ply + 1, -beta, -alpha).value;
+        }
+        else
+        {
+            int reduction = getLateMoveReduction(depth, numMovesTried, action);
+
+            // alpha + 1 sends a move that is not reduced straight to the full depth search
+            value = alpha + 1;
+
+            if (reduction > 0)
+            {
+                lateMoveReductions++;
+                value = -pvsValue<Board::getOpponentColor(color)>(state, depth - 1 - reduction, ply + 1, -alpha - 1, -alpha).value;
+
+                if (value > alpha)
+                    lateMoveResearches++;
+            }
+
+            if (value > alpha)
+                value = -pvsValue<Board::getOpponentColor(color)>(state, depth - 1, ply + 1, -alpha - 1, -alpha).value;
+
+            // better than alpha, so the null window only gave a lower bound
+            if (value > alpha && value < beta)
+            {
+                nullWindowResearches++;
+                value = -pvsValue<Board::getOpponentColor(color)>(state, depth - 1, ply + 1, -beta, -alpha).value;
+            }
+        }
+
+        state.unmakeMove<color>(action, undo);
+
+        if (value > result.value)
+        {
+            result.value = value;
+            bestMove = action;
+        }
+
+        if (result.value >= beta)
+        {
+            countGeneratedPieces(picker);
+            recordCutoff(color, action, ply, depth, numMovesTried);
+            result.bestMove = action;
+            storeTable(key, depth, alphaAtEntry, beta, result);
+            return result;
+        }
+
+        alpha = std::max(alpha, result.value);
     }
 
+    countGeneratedPieces(picker);
+
     result.bestMove = bestMove;
+    storeTable(key, depth, alphaAtEntry, beta, result);
     return result;
 }
 
+/**
+ * Late move reductions. With good move ordering, a quiet move far down a node's order rarely
+ * turns out best, so it is searched less deep, and only searched again at full depth if the
+ * shallow search says it beats the window. Jumps, the first few moves, the root and nodes with
+ * little depth left are never reduced.
+ *
+ * The reduction grows with the log of both the depth left and the move number, and is rounded
+ * down to an even number of plies. maxValue and minValue score a leaf for the player to move
+ * there, so an odd reduction would change whose score a leaf is; pvsValue does not have that
+ * problem, but the evaluations swing enough between odd and even depths that comparing a reduced
+ * score against a full depth alpha sent most odd reductions back for a re-search.
+ *
+ * @param int depth - the plies left to search below the node
+ * @param int moveNumber - 1 for the first move tried at the node, 2 for the second and so on
+ * @param Board::PackedMove move - the move about to be searched
+ *
+ * @return int - how many plies less to search the move, 0 for a full depth search
+ */
+int Algorithm::getLateMoveReduction(int depth, int moveNumber, Board::PackedMove move)
+{
+    struct ReductionTable
+    {
+        int reductions[LMR_TABLE_DEPTHS][LMR_TABLE_MOVES];
+
+        ReductionTable()
+        {
+            for (int depthIter = 0; depthIter < LMR_TABLE_DEPTHS; depthIter++)
+                for (int moveIter = 0; moveIter < LMR_TABLE_MOVES; moveIter++)
+                    reductions[depthIter][moveIter] =
+                        (depthIter == 0 || moveIter == 0) ? 0 : (int)(0.5 + std::log(depthIter) * std::log(moveIter) / 1.5);
+        }
+    };
+
+    static const ReductionTable table;
+
+    if (!reduceLateMoves || depth < LMR_MIN_DEPTH || depth == maxDepth || moveNumber <= LMR_FULL_DEPTH_MOVES ||
+        move.isCapture())
+        return 0;
+
+    int reduction = table.reductions[std::min(depth, LMR_TABLE_DEPTHS - 1)][std::min(moveNumber, LMR_TABLE_MOVES - 1)];
+
+    // leave at least one ply, so the move itself is still searched
+    reduction = std::min(reduction, depth - 2);
+
+    return reduction & ~1;
+}
+
+/**
+ * horizonValue scores a node the search has reached the depth limit at. Without useQuiescence
+ * that is its evaluation. With it, a player who still has a jump to make is not evaluated
+ * mid-exchange; see quiescence. Either way a quiet node gets its evaluation for the player to
+ * move, as each search has always scored its leaves.
+ *
+ * @param Board &state - the position at the depth limit, with the template color to move
+ * @param int ply - how many plies the position is below the root
+ * @param int alpha, beta - the window the score is wanted in, as the caller compares it
+ *
+ * @return int - the score, for the player to move
+ */
+template <Color color>
+int Algorithm::horizonValue(Board &state, int ply, int alpha, int beta)
+{
+    if (!useQuiescence)
+        return staticEval(state, color, evalVersion);
+
+    return quiescence<color>(state, alpha, beta, color, ply);
+}
+
+/**
+ * quiescence searches past the depth limit, a negamax alpha-beta over jumps only. A player with
+ * no jump stands pat: the position is quiet and its evaluation is its score. A player with a jump
+ * must take it, so cannot stand pat, and the jumps are searched instead, most pieces taken first,
+ * until a cutoff or a quiet position. Every jump takes a piece, so this always ends.
+ *
+ * All positions are evaluated for evalColor, the player to move at the depth limit, so the score
+ * means the same as the evaluation there would have; the other player's score is its negation.
+ *
+ * @param Board &state - moves are made and taken back on it in place
+ * @param int alpha, beta - the window, for the player to move
+ * @param Color evalColor - the player the evaluation is made for
+ * @param int ply - how many plies the position is below the root
+ *
+ * @return int - the score, for the player to move
+ */
+template <Color color>
+int Algorithm::quiescence(Board &state, int alpha, int beta, Color evalColor, int ply)
+{
+    if (isOutOfTime())
+        return 0;
+
+    // stand pat
+    if (state.getJumpingPiecesMask<color>() == 0)
+    {
+        int standPat = staticEval(state, evalColor, evalVersion);
+        return (color == evalColor) ? standPat : -standPat;
+    }
+
+    quiescenceNodes++;
+
+    // the windows of maxValue and minValue start at the lowest int, which cannot be negated
+    alpha = std::max(alpha, -std::numeric_limits<int>::max());
+
+    MovePicker<color> picker(state, collapseDuplicateCaptures, orderMoves ? &moveOrdering : NULL, Board::PackedMove(), ply);
+    Board::PackedMove jump;
+    int bestValue = -std::numeric_limits<int>::max();
+
+    while (picker.nextMove(jump))
+    {
+        Board::Undo undo;
+        state.makeMove<color>(jump, undo);
+        int value = -quiescence<Board::getOpponentColor(color)>(state, -beta, -alpha, evalColor, ply + 1);
+        state.unmakeMove<color>(jump, undo);
+
+        bestValue = std::max(bestValue, value);
+
+        if (bestValue >= beta)
+            break;
+
+        alpha = std::max(alpha, bestValue);
+    }
+
+    countGeneratedPieces(picker);
+    return bestValue;
+}
+
 /**
  * Helper function to switch a color, so if we are RED and we want our opponent, we would get BACK
  * @author Borislav Sabotinov
@@ -1203,6 +1736,114 @@ Color Algorithm::switchPlayerColor(Color color)
         return Color::RED;
 }
 
+/**
+ * Adds the work a node's move picker did to the search totals, so the moves skipped by cutoffs
+ * can be reported. Counted in pieces, since moves are built one piece at a time.
+ *
+ * @param MovePicker &picker - the picker of a node that is done searching
+ */
+template <Color color>
+void Algorithm::countGeneratedPieces(MovePicker<color> &picker)
+{
+    piecesGenerated += picker.getNumPiecesGenerated();
+    piecesToGenerate += picker.getNumPiecesToGenerate();
+}
+
+/**
+ * Counts a cutoff and how far into the node's moves it came, which is how good the move ordering
+ * is: the more often the first move is enough, the less of the tree is searched. Quiet moves that
+ * cut off become killers and gain history, see MoveOrdering::addCutoff.
+ *
+ * @param Color color - the player whose move caused the cutoff
+ * @param Board::PackedMove move - the move that caused the cutoff
+ * @param int ply - how many plies the node is below the root, which its killers are kept for
+ * @param int depth - the plies left to search below the node
+ * @param int moveNumber - 1 for the first move tried at the node, 2 for the second and so on
+ */
+void Algorithm::recordCutoff(Color color, Board::PackedMove move, int ply, int depth, int moveNumber)
+{
+    betaCutoffs++;
+
+    if (moveNumber == 1)
+        firstMoveCutoffs++;
+
+    if (orderMoves)
+        moveOrdering.addCutoff(color, move, ply, depth);
+}
+
+/**
+ * Looks a node up in the transposition table before it is searched. A stored score settles the
+ * node when it came from a search at least as deep as this one and is exact, or is a bound that
+ * already falls outside the window. The root is always searched, so the move it returns comes
+ * from this search. Any stored move is passed back to be tried first, whatever its depth.
+ *
+ * The evaluation functions score a leaf for the player to move there, so a search that ends on
+ * the other player gives a score of another kind. Only stored depths of the same parity are used.
+ *
+ * @param uint64_t key - the Board hash key of the node
+ * @param int depth - the plies left to search below the node
+ * @param int alpha, beta - the window the node was entered with
+ * @param Result &result - returns the stored score and move when the node is settled
+ * @param Board::PackedMove &hashMove - returns the stored move when the node was found
+ *
+ * @return bool - true if the node need not be searched
+ */
+bool Algorithm::probeTable(uint64_t key, int depth, int alpha, int beta, Result &result, Board::PackedMove &hashMove)
+{
+    TranspositionTable::Entry entry;
+
+    if (!transpositionTable)
+        return false;
+
+    tableProbes++;
+
+    if (!transpositionTable->probe(key, entry))
+        return false;
+
+    tableHits++;
+    hashMove = entry.move;
+
+    if (depth == maxDepth || entry.depth < depth || (entry.depth - depth) % 2 != 0)
+        return false;
+
+    if (entry.bound == TranspositionTable::EXACT ||
+        (entry.bound == TranspositionTable::LOWER_BOUND && entry.score >= beta) ||
+        (entry.bound == TranspositionTable::UPPER_BOUND && entry.score <= alpha))
+    {
+        tableCutoffs++;
+        result.value = entry.score;
+        result.bestMove = entry.move;
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * Keeps the result of a searched node in the transposition table. Whether the score is exact or
+ * a bound follows from the window the node was entered with.
+ *
+ * @param uint64_t key - the Board hash key of the node
+ * @param int depth - the plies searched below the node
+ * @param int alpha, beta - the window the node was entered with
+ * @param const Result &result - the score and best move the node returns
+ */
+void Algorithm::storeTable(uint64_t key, int depth, int alpha, int beta, const Result &result)
+{
+    // a stopped search returns made up scores
+    if (!transpositionTable || isStopped)
+        return;
+
+    TranspositionTable::Bound bound = TranspositionTable::EXACT;
+
+    if (result.value <= alpha)
+        bound = TranspositionTable::UPPER_BOUND;
+    else if (result.value >= beta)
+        bound = TranspositionTable::LOWER_BOUND;
+
+    transpositionTable->store(key, depth, bound, result.value, result.bestMove);
+}
+
 /**
  * terminalTest function is used by alpha-beta-search to determine if 
  * the move either ends the game or leads to a leaf node.
@@ -1216,15 +1857,13 @@ Color Algorithm::switchPlayerColor(Color color)
  * 
  * @return bool isTerminalState
  */
-bool Algorithm::terminalTest(Board state, int depth)
+bool Algorithm::terminalTest(Board &state, int depth)
 {
     bool isTerminalState = false;
-    std::vector<Board::Move> redMoves = state.moveGen(Color::RED);
-    std::vector<Board::Move> blackMoves = state.moveGen(Color::BLACK);
     if (Pieces::ouputDebugData)
-        std::cout << "Red Moves " << redMoves.size() << "  Black Moves  " << blackMoves.size() << std::endl;
+        std::cout << "Red Moves " << state.moveGen(Color::RED).size() << "  Black Moves  " << state.moveGen(Color::BLACK).size() << std::endl;
 
-    if (redMoves.size() == 0 || blackMoves.size() == 0)
+    if (!state.hasAnyMove(Color::RED) || !state.hasAnyMove(Color::BLACK))
         isTerminalState = true;
 
     return isTerminalState;
@@ -1235,7 +1874,7 @@ bool Algorithm::terminalTest(Board state, int depth)
  * Essentially a wrapper function that calls staticEval
  * @author Borislav Sabotinov
  */
-int Algorithm::utility(Board state)
+int Algorithm::utility(Board &state)
 {
     //return staticEval(state, this->callingPlayer, this->evalVersion);
     return 1;
@@ -1248,19 +1887,115 @@ int Algorithm::utility(Board state)
  * 
  * @param Board state
  * 
- * @return vector<Board::Move> - a list of possible moves for a player of a given color 
+ * @return Board::MoveList - a list of possible moves for a player of a given color 
  */
-std::vector<Board::Move> Algorithm::actions(Board state, Color color)
+Board::MoveList Algorithm::actions(Board &state, Color color)
 {
     return state.moveGen(color);
 }
 
+/**
+ * Checks the clock for a search with a deadline. Reading the clock costs about as much as a small
+ * node, so it is only read every CLOCK_CHECK_INTERVAL nodes. Once the deadline has passed the
+ * answer stays true, and every node returns at once with a score of 0.
+ *
+ * @return bool - true if the search must stop
+ */
+bool Algorithm::isOutOfTime()
+{
+    if (!hasDeadline || isStopped)
+        return isStopped;
+
+    if (++nodesSinceClockCheck < CLOCK_CHECK_INTERVAL)
+        return false;
+
+    nodesSinceClockCheck = 0;
+    isStopped = high_resolution_clock::now() >= deadline;
+
+    return isStopped;
+}
+
+/**
+ * Set the time at which the search stops, wherever it is. The scores and move of a stopped search
+ * are not those of a full search and are thrown away; see Player::takeTurn.
+ */
+void Algorithm::setDeadline(high_resolution_clock::time_point deadline)
+{
+    this->hasDeadline = true;
+    this->deadline = deadline;
+}
+
+/**
+ * Set the score the root is expected to get, usually from an earlier search of the same position
+ * or of the position a move pair earlier. The evaluation functions score leaves for the player to
+ * move there, so for alphaBetaSearch the earlier search must have the same depth parity.
+ */
+void Algorithm::setExpectedValue(int expectedValue)
+{
+    this->hasExpectedValue = true;
+    this->expectedValue = expectedValue;
+}
+
+/**
+ * The aspiration window each evaluation function starts with. The functions score on very
+ * different scales, evalFunctThree for example counting a safe capture as 1000, so each has its
+ * own. Narrow windows fail more often, but in searches of depth 4 to 8 the re-searches cost less
+ * than the narrow windows save, down to about a tenth of the typical change between searches two
+ * plies apart. Below that they stop paying: 5 for evalFunctOne searched more nodes than no window
+ * on some positions. The aspiration counts of Algorithm and Player are there to retune them.
+ *
+ * @param int evalVersion - 1, 2, or 3
+ *
+ * @return int - half the width of the window, 0 for no aspiration window
+ */
+int Algorithm::getDefaultAspirationWindow(int evalVersion)
+{
+    switch (evalVersion)
+    {
+    case 1:
+        return 10;
+    case 2:
+        return 30;
+    case 3:
+        return 100;
+    default:
+        return 0;
+    }
+}
+
+/**
+ * The phase of the game an evaluation function is in. evalFunctOne weighs pieces and mobility
+ * differently from EVAL_ONE_ENDGAME_TURN on, so a score it gave before then is not comparable
+ * with one it gives after; the other functions score the same way all game.
+ *
+ * @param int evalVersion - 1, 2, or 3
+ * @param int numTurns - the turns the calling player has taken
+ *
+ * @return int - 0, or 1 once evalFunctOne uses its endgame weights
+ */
+int Algorithm::getEvaluationPhase(int evalVersion, int numTurns)
+{
+    if (evalVersion == 1 && numTurns >= EVAL_ONE_ENDGAME_TURN)
+        return 1;
+
+    return 0;
+}
+
+/**
+ * True if the search ran past its deadline and stopped early
+ */
+bool Algorithm::wasStopped()
+{
+    return isStopped;
+}
+
 /**
  * Set the evaluation function version - 1, 2, or 3
  */
 void Algorithm::setEvalVersion(int evalVersion)
 {
     this->evalVersion = evalVersion;
+    this->aspirationWindow = getDefaultAspirationWindow(evalVersion);
 }
 
 /**
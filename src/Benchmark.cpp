@@ -0,0 +1,1274 @@
+#include "Benchmark.hpp"
+#include "Algorithm.hpp"
+#include "BoardBatch.hpp"
+#include "TranspositionTable.hpp"
+#include "Player.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <vector>
+
+/**
+ * Benchmark implementation
+ *
+ * Measures parts of the engine outside of a game. Started from main() with the -bench CLI argument.
+ */
+
+std::atomic<long long> Benchmark::allocationCount(0);
+
+// The positions the search benchmarks compare on, scored with evalFunctOne: the initial board, and a
+// king endgame where the same positions come up by many move orders
+static const int SEARCH_EVAL_VERSION = 1;
+static const int NUM_SEARCH_POSITIONS = 2;
+static const char *const SEARCH_POSITIONS[NUM_SEARCH_POSITIONS] = {"B:R1-12:B21-32", "B:R3,K6,K10,15:B18,K23,K27,30"};
+
+#ifdef COUNT_ALLOCATIONS
+/**
+ * Replacement global operator new and delete, in every form up to C++14. They behave like the
+ * library versions, but count every allocation so that the benchmark can report how often a
+ * search touches the heap. They are only built into the binary made by "make CheckersAI-bench",
+ * so games in the normal binary do not pay for the counter.
+ */
+static void *countedAllocate(std::size_t size)
+{
+    Benchmark::allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void *operator new(std::size_t size)
+{
+    void *memory = countedAllocate(size);
+    if (memory == NULL)
+        throw std::bad_alloc();
+
+    return memory;
+}
+
+void *operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    return countedAllocate(size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+    return countedAllocate(size);
+}
+
+void operator delete(void *memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void *memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void *memory, const std::nothrow_t &) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void *memory, const std::nothrow_t &) noexcept
+{
+    std::free(memory);
+}
+
+#ifdef __cpp_sized_deallocation
+void operator delete(void *memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void *memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+#endif
+#endif // COUNT_ALLOCATIONS
+
+Benchmark::Benchmark()
+{
+}
+
+Benchmark::~Benchmark()
+{
+}
+
+/**
+ * Runs every benchmark in turn. Debug output is turned off first, since printing
+ * would dominate every measurement.
+ */
+void Benchmark::runAll()
+{
+    Pieces::ouputDebugData = 0;
+
+    runBoardConstruction();
+    runWinChecks();
+    runSkippedGeneration();
+    runAllocationCount();
+    runPositionText();
+    runBatchMoveMasks();
+    runDuplicateCaptures();
+    runCanonicalKeys();
+    runThreatMasks();
+    runLegalityChecks();
+    runTranspositionTable();
+    runMoveOrdering();
+    runPrincipalVariation();
+    runAspirationWindows();
+    runQuiescence();
+    runTimeToDepth();
+}
+
+/**
+ * Times how long a Board takes to construct. The first construction in the program is timed
+ * on its own, since it may have to set up shared tables. updateBoard, which copies a board and
+ * plays one move on it, is timed as the per-node cost a copying search would pay.
+ */
+void Benchmark::runBoardConstruction()
+{
+    const int numBoards = 1000000;
+    long long checksum = 0;
+
+    auto t1 = high_resolution_clock::now();
+    Board firstBoard;
+    auto t2 = high_resolution_clock::now();
+    duration<double, std::micro> startupTime = t2 - t1;
+
+    t1 = high_resolution_clock::now();
+    for (int boardIter = 0; boardIter < numBoards; boardIter++)
+    {
+        Board board;
+        checksum += board.getPieceInSquare(1 + boardIter % 32, Color::RED);
+    }
+    t2 = high_resolution_clock::now();
+    duration<double, std::nano> constructionTime = t2 - t1;
+
+    Board::MoveList moves = firstBoard.moveGen(Color::BLACK);
+
+    t1 = high_resolution_clock::now();
+    for (int boardIter = 0; boardIter < numBoards; boardIter++)
+    {
+        Board board = firstBoard.updateBoard(moves.at(boardIter % moves.size()), Color::BLACK);
+        checksum += board.getPieceInSquare(1 + boardIter % 32, Color::BLACK);
+    }
+    t2 = high_resolution_clock::now();
+    duration<double, std::nano> updateTime = t2 - t1;
+
+    std::cout << "Board construction" << std::endl;
+    std::cout << "  first Board(): " << startupTime.count() << " us" << std::endl;
+    std::cout << "  Board(): " << constructionTime.count() / numBoards << " ns each" << std::endl;
+    std::cout << "  updateBoard(): " << updateTime.count() / numBoards << " ns each"
+              << " (checksum " << checksum << ")" << std::endl;
+}
+
+/**
+ * Times the win checks the game loop makes after every turn, asking whether either side has a
+ * move left. The check is done both by generating each side's moves and testing for an empty
+ * list, and by Board::hasAnyMove, over every position of a fixed game.
+ */
+void Benchmark::runWinChecks()
+{
+    const int numPlies = 60;
+    const int numRepeats = 20000;
+    std::vector<Board> positions;
+    long long listChecksum = 0, predicateChecksum = 0;
+
+    for (int ply = 0; ply < numPlies; ply++)
+    {
+        Color sideToMove;
+        positions.push_back(playFixedOpening(ply, sideToMove));
+    }
+
+    auto t1 = high_resolution_clock::now();
+    for (int repeat = 0; repeat < numRepeats; repeat++)
+    {
+        for (size_t posIter = 0; posIter < positions.size(); posIter++)
+        {
+            Board::MoveList redMoves = positions[posIter].moveGen(Color::RED);
+            Board::MoveList blackMoves = positions[posIter].moveGen(Color::BLACK);
+            listChecksum += (redMoves.size() == 0) + (blackMoves.size() == 0);
+        }
+    }
+    auto t2 = high_resolution_clock::now();
+    duration<double, std::nano> listTime = t2 - t1;
+
+    t1 = high_resolution_clock::now();
+    for (int repeat = 0; repeat < numRepeats; repeat++)
+    {
+        for (size_t posIter = 0; posIter < positions.size(); posIter++)
+        {
+            predicateChecksum += !positions[posIter].hasAnyMove(Color::RED) + !positions[posIter].hasAnyMove(Color::BLACK);
+        }
+    }
+    t2 = high_resolution_clock::now();
+    duration<double, std::nano> predicateTime = t2 - t1;
+
+    long long numChecks = (long long)numRepeats * positions.size();
+
+    std::cout << "Win checks, both colors, over " << positions.size() << " positions" << std::endl;
+    std::cout << "  moveGen().size() == 0: " << listTime.count() / numChecks << " ns each"
+              << " (checksum " << listChecksum << ")" << std::endl;
+    std::cout << "  !hasAnyMove(): " << predicateTime.count() / numChecks << " ns each"
+              << " (checksum " << predicateChecksum << ")" << std::endl;
+}
+
+/**
+ * Searches a few fixed positions with both algorithms and reports how many pieces had their moves
+ * built by the MovePicker, against how many a full Board::moveGen at every searched node would
+ * have built. The difference is the generation work skipped by cutoffs.
+ */
+void Benchmark::runSkippedGeneration()
+{
+    const int depth = 6;
+    const int evalVersion = 1;
+    std::string algs[2] = {"Alpha-Beta-Search", "Minimax-Alpha-Beta"};
+
+    std::cout << "Move generation skipped by cutoffs, depth " << depth << ", eval " << evalVersion << std::endl;
+
+    for (int isMinimax = 0; isMinimax <= 1; isMinimax++)
+    {
+        long long piecesGenerated = 0, piecesToGenerate = 0;
+
+        for (int openingPlies = 0; openingPlies <= 30; openingPlies += 10)
+        {
+            Color sideToMove;
+            Board state = playFixedOpening(openingPlies, sideToMove);
+            Player player(isMinimax, sideToMove, depth, evalVersion);
+            Algorithm algorithm(evalVersion, depth, player);
+
+            if (isMinimax)
+                algorithm.minimax_a_b(state, depth, sideToMove, 9000000, -8000000);
+            else
+                algorithm.alphaBetaSearch(state);
+
+            piecesGenerated += algorithm.piecesGenerated;
+            piecesToGenerate += algorithm.piecesToGenerate;
+        }
+
+        std::cout << "  " << algs[isMinimax] << ": pieces generated " << piecesGenerated << " of " << piecesToGenerate
+                  << ", skipped " << 100.0 * (piecesToGenerate - piecesGenerated) / (piecesToGenerate > 0 ? piecesToGenerate : 1)
+                  << "%" << std::endl;
+    }
+}
+
+/**
+ * Searches a few fixed positions with both algorithms and all three evaluation functions,
+ * and reports how many heap allocations each search made per node it visited.
+ * Move generation, make/update of boards and the evaluations should all run off the stack,
+ * so anything other than zero points at a regression. Allocations are only counted in the
+ * binary built with COUNT_ALLOCATIONS, see the Makefile.
+ */
+void Benchmark::runAllocationCount()
+{
+    const int depth = 4;
+    std::string algs[2] = {"Alpha-Beta-Search", "Minimax-Alpha-Beta"};
+
+#ifndef COUNT_ALLOCATIONS
+    std::cout << "Heap allocations: not counted, build with \"make CheckersAI-bench\" to count them" << std::endl;
+    return;
+#endif
+
+    std::cout << "Heap allocations per searched node, depth " << depth << std::endl;
+
+    for (int openingPlies = 0; openingPlies <= 20; openingPlies += 10)
+    {
+        Color sideToMove;
+        Board state = playFixedOpening(openingPlies, sideToMove);
+
+        for (int isMinimax = 0; isMinimax <= 1; isMinimax++)
+        {
+            for (int evalVersion = 1; evalVersion <= 3; evalVersion++)
+            {
+                Player player(isMinimax, sideToMove, depth, evalVersion);
+                Algorithm algorithm(evalVersion, depth, player);
+                long long numNodes;
+
+                long long allocationsBefore = allocationCount.load();
+
+                if (isMinimax)
+                {
+                    algorithm.minimax_a_b(state, depth, sideToMove, 9000000, -8000000);
+                    numNodes = algorithm.minimaxExpandedNodes + algorithm.minimaxLeafNodes;
+                }
+                else
+                {
+                    algorithm.alphaBetaSearch(state);
+                    numNodes = algorithm.absearchExpandedNodes + algorithm.absearchLeafNodes;
+                }
+
+                long long numAllocations = allocationCount.load() - allocationsBefore;
+
+                std::cout << "  ply " << openingPlies << ", " << algs[isMinimax] << ", eval " << evalVersion
+                          << ": nodes " << numNodes << ", allocations " << numAllocations
+                          << ", per node " << (double)numAllocations / (numNodes > 0 ? numNodes : 1) << std::endl;
+            }
+        }
+    }
+}
+
+/**
+ * Times Board::parsePosition and Board::toPosition over the positions of a fixed game, as a batch
+ * job reading a file of positions would use them. Every position is also checked to read back
+ * as the same board it was written from.
+ */
+void Benchmark::runPositionText()
+{
+    const int numPlies = 60;
+    const int numRepeats = 20000;
+    std::vector<std::string> positionTexts;
+    int numRoundTripErrors = 0;
+    long long checksum = 0;
+
+    for (int ply = 0; ply < numPlies; ply++)
+    {
+        Color sideToMove;
+        Board board = playFixedOpening(ply, sideToMove);
+        Board parsedBoard;
+
+        positionTexts.push_back(board.toPosition());
+
+        if (!Board::parsePosition(positionTexts.back(), parsedBoard) || parsedBoard.toPosition() != positionTexts.back() ||
+            parsedBoard.getSideToMove() != sideToMove)
+            numRoundTripErrors++;
+    }
+
+    auto t1 = high_resolution_clock::now();
+    for (int repeat = 0; repeat < numRepeats; repeat++)
+    {
+        for (size_t posIter = 0; posIter < positionTexts.size(); posIter++)
+        {
+            Board board;
+            checksum += Board::parsePosition(positionTexts[posIter], board) + board.getPieceInSquare(1 + posIter % 32, Color::RED);
+        }
+    }
+    auto t2 = high_resolution_clock::now();
+    duration<double> parseTime = t2 - t1;
+
+    Board board;
+    Board::parsePosition(positionTexts[numPlies / 2], board);
+
+    t1 = high_resolution_clock::now();
+    for (int repeat = 0; repeat < numRepeats * numPlies; repeat++)
+    {
+        checksum += board.toPosition().size();
+    }
+    t2 = high_resolution_clock::now();
+    duration<double> writeTime = t2 - t1;
+
+    long long numPositions = (long long)numRepeats * numPlies;
+
+    std::cout << "Position text, over " << positionTexts.size() << " positions, e.g. " << positionTexts[numPlies / 2] << std::endl;
+    std::cout << "  parsePosition(): " << (long long)(numPositions / parseTime.count()) << " positions/s" << std::endl;
+    std::cout << "  toPosition(): " << (long long)(numPositions / writeTime.count()) << " positions/s"
+              << " (checksum " << checksum << ", round trip errors " << numRoundTripErrors << ")" << std::endl;
+}
+
+/**
+ * Times the movable and jumping piece masks, for the side to move, over a batch of boards taken
+ * from a fixed game. They are computed one board at a time with the Board functions, then by
+ * BoardBatch without and with vector instructions. Every batch result is checked against the
+ * Board functions.
+ */
+void Benchmark::runBatchMoveMasks()
+{
+    const int numPlies = 60;
+    const int numCopies = 101; // leaves a few boards past the last whole vector
+    const int numRepeats = 500;
+    std::vector<Board> boards;
+    BoardBatch batch;
+    std::vector<uint32_t> movablePieces, jumpingPieces;
+    long long boardChecksum = 0, scalarChecksum = 0, batchChecksum = 0;
+    int numMismatches = 0;
+
+    for (int copy = 0; copy < numCopies; copy++)
+    {
+        for (int ply = 0; ply < numPlies; ply++)
+        {
+            Color sideToMove;
+            boards.push_back(playFixedOpening(ply, sideToMove));
+            batch.add(boards.back());
+        }
+    }
+
+    auto t1 = high_resolution_clock::now();
+    for (int repeat = 0; repeat < numRepeats; repeat++)
+    {
+        for (size_t boardIter = 0; boardIter < boards.size(); boardIter++)
+        {
+            Color sideToMove = boards[boardIter].getSideToMove();
+            boardChecksum += boards[boardIter].getMovablePiecesMask(sideToMove) ^ boards[boardIter].getJumpingPiecesMask(sideToMove);
+        }
+    }
+    auto t2 = high_resolution_clock::now();
+    duration<double> boardTime = t2 - t1;
+
+    t1 = high_resolution_clock::now();
+    for (int repeat = 0; repeat < numRepeats; repeat++)
+    {
+        batch.computeMoveMasksScalar(movablePieces, jumpingPieces);
+        scalarChecksum += movablePieces[repeat % batch.size()] ^ jumpingPieces[repeat % batch.size()];
+    }
+    t2 = high_resolution_clock::now();
+    duration<double> scalarTime = t2 - t1;
+
+    t1 = high_resolution_clock::now();
+    for (int repeat = 0; repeat < numRepeats; repeat++)
+    {
+        batch.computeMoveMasks(movablePieces, jumpingPieces);
+        batchChecksum += movablePieces[repeat % batch.size()] ^ jumpingPieces[repeat % batch.size()];
+    }
+    t2 = high_resolution_clock::now();
+    duration<double> batchTime = t2 - t1;
+
+    for (size_t boardIter = 0; boardIter < boards.size(); boardIter++)
+    {
+        Color sideToMove = boards[boardIter].getSideToMove();
+
+        if (movablePieces[boardIter] != boards[boardIter].getMovablePiecesMask(sideToMove) ||
+            jumpingPieces[boardIter] != boards[boardIter].getJumpingPiecesMask(sideToMove))
+            numMismatches++;
+    }
+
+    long long numBoards = (long long)numRepeats * boards.size();
+
+    std::cout << "Move masks over " << boards.size() << " boards, AVX2 " << (BoardBatch::isVectorized() ? "used" : "not available")
+              << std::endl;
+    std::cout << "  Board, one at a time: " << (long long)(numBoards / boardTime.count()) << " boards/s"
+              << " (checksum " << boardChecksum << ")" << std::endl;
+    std::cout << "  BoardBatch, scalar: " << (long long)(numBoards / scalarTime.count()) << " boards/s"
+              << " (checksum " << scalarChecksum << ")" << std::endl;
+    std::cout << "  BoardBatch: " << (long long)(numBoards / batchTime.count()) << " boards/s"
+              << " (checksum " << batchChecksum << ", mismatches " << numMismatches << ")" << std::endl;
+}
+
+/**
+ * Measures what collapsing a king's jump routes that lead to the same position saves, on random
+ * king-heavy endgames. The moves listed with and without collapsing give the drop in branching
+ * factor. The first few endgames with a duplicate at the root are then searched both ways by both
+ * algorithms, for the drop in nodes searched.
+ */
+void Benchmark::runDuplicateCaptures()
+{
+    const int numPositions = 20000;
+    const int numSearched = 20;
+    const int depth = 6;
+    const int evalVersion = 1;
+    unsigned long long seed = 12345;
+    long long numMoves = 0, numCollapsedMoves = 0;
+    long long numDuplicateMoves = 0, numDuplicateCollapsedMoves = 0;
+    long long numNodes[2] = {0, 0}, numCollapsedNodes[2] = {0, 0};
+    std::string algs[2] = {"Alpha-Beta-Search", "Minimax-Alpha-Beta"};
+    int numPositionsWithDuplicates = 0;
+
+    for (int posIter = 0; posIter < numPositions; posIter++)
+    {
+        Board state = makeKingEndgame(seed);
+        Color sideToMove = state.getSideToMove();
+        int moveCount = state.moveGen(sideToMove).size();
+        int collapsedMoveCount = state.moveGen(sideToMove, true).size();
+
+        numMoves += moveCount;
+        numCollapsedMoves += collapsedMoveCount;
+
+        if (collapsedMoveCount == moveCount)
+            continue;
+
+        numPositionsWithDuplicates++;
+        numDuplicateMoves += moveCount;
+        numDuplicateCollapsedMoves += collapsedMoveCount;
+
+        if (numPositionsWithDuplicates <= numSearched)
+        {
+            for (int isMinimax = 0; isMinimax <= 1; isMinimax++)
+            {
+                for (int collapse = 0; collapse <= 1; collapse++)
+                {
+                    Player player(isMinimax, sideToMove, depth, evalVersion);
+                    Algorithm algorithm(evalVersion, depth, player);
+                    algorithm.reduceLateMoves = false;
+                    algorithm.collapseDuplicateCaptures = collapse;
+                    long long searchNodes;
+
+                    if (isMinimax)
+                    {
+                        algorithm.minimax_a_b(state, depth, sideToMove, 9000000, -8000000);
+                        searchNodes = algorithm.minimaxExpandedNodes + algorithm.minimaxLeafNodes;
+                    }
+                    else
+                    {
+                        algorithm.alphaBetaSearch(state);
+                        searchNodes = algorithm.absearchExpandedNodes + algorithm.absearchLeafNodes;
+                    }
+
+                    (collapse ? numCollapsedNodes : numNodes)[isMinimax] += searchNodes;
+                }
+            }
+        }
+    }
+
+    std::cout << "Duplicate king captures over " << numPositions << " king endgames" << std::endl;
+    std::cout << "  branching factor: " << (double)numMoves / numPositions << " listed, "
+              << (double)numCollapsedMoves / numPositions << " collapsed" << std::endl;
+    std::cout << "  in the " << numPositionsWithDuplicates << " positions with duplicates: "
+              << (double)numDuplicateMoves / (numPositionsWithDuplicates > 0 ? numPositionsWithDuplicates : 1) << " listed, "
+              << (double)numDuplicateCollapsedMoves / (numPositionsWithDuplicates > 0 ? numPositionsWithDuplicates : 1)
+              << " collapsed" << std::endl;
+    for (int isMinimax = 0; isMinimax <= 1; isMinimax++)
+        std::cout << "  " << algs[isMinimax] << " depth " << depth << " nodes over the first " << numSearched
+                  << " with duplicates: " << numNodes[isMinimax] << " listed, " << numCollapsedNodes[isMinimax]
+                  << " collapsed, " << 100.0 * (numNodes[isMinimax] - numCollapsedNodes[isMinimax]) /
+                                           (numNodes[isMinimax] > 0 ? numNodes[isMinimax] : 1)
+                  << "% fewer" << std::endl;
+}
+
+/**
+ * Counts the distinct positions within a few plies of two fixed positions, once by hash key and
+ * once by canonical hash key. The difference is the number of positions whose flipped version,
+ * colors swapped and board turned around, was also reached, which a cache keyed on the canonical
+ * key stores once. The cost of the canonical key against the plain key is timed as well.
+ */
+void Benchmark::runCanonicalKeys()
+{
+    const int depth = 8;
+    const int numRepeats = 10000000;
+    std::string positions[2] = {"B:R1-12:B21-32", "B:RK6,K10,15:BK18,K23,K27"};
+
+    std::cout << "Canonical keys, positions within " << depth << " plies" << std::endl;
+
+    for (int posIter = 0; posIter < 2; posIter++)
+    {
+        Board state;
+        std::unordered_set<uint64_t> keys, canonicalKeys;
+
+        Board::parsePosition(positions[posIter], state);
+        collectKeys(state, depth, keys, canonicalKeys);
+
+        std::cout << "  " << positions[posIter] << ": " << keys.size() << " keys, " << canonicalKeys.size()
+                  << " canonical keys, " << 100.0 * (keys.size() - canonicalKeys.size()) / keys.size() << "% fewer" << std::endl;
+    }
+
+    Color sideToMove;
+    Board board = playFixedOpening(11, sideToMove);
+    uint64_t checksum = 0;
+    bool isFlipped;
+
+    auto t1 = high_resolution_clock::now();
+    for (int repeat = 0; repeat < numRepeats; repeat++)
+    {
+        checksum += board.getCanonicalHashKey(isFlipped) + repeat;
+    }
+    auto t2 = high_resolution_clock::now();
+    duration<double, std::nano> canonicalTime = t2 - t1;
+
+    std::cout << "  getCanonicalHashKey(): " << canonicalTime.count() / numRepeats << " ns each (checksum " << checksum
+              << ")" << std::endl;
+}
+
+/**
+ * Times finding the pieces each side could lose to a jump, over every position of a fixed game.
+ * The move list way generates the opponent's moves and collects the first piece each jump takes,
+ * as the evaluation functions do. Board::getAttackedMask gives the same squares from the piece
+ * masks, and the checksums show the two agree. Board::getHangingMask is timed as well.
+ */
+void Benchmark::runThreatMasks()
+{
+    const int numPlies = 60;
+    const int numRepeats = 20000;
+    std::vector<Board> positions;
+    long long listChecksum = 0, maskChecksum = 0, hangingChecksum = 0;
+
+    for (int ply = 0; ply < numPlies; ply++)
+    {
+        Color sideToMove;
+        positions.push_back(playFixedOpening(ply, sideToMove));
+    }
+
+    auto t1 = high_resolution_clock::now();
+    for (int repeat = 0; repeat < numRepeats; repeat++)
+    {
+        for (size_t posIter = 0; posIter < positions.size(); posIter++)
+        {
+            for (int colorIter = 0; colorIter < 2; colorIter++)
+            {
+                Color color = colorIter ? Color::RED : Color::BLACK;
+                Board::MoveList opponentMoves = positions[posIter].moveGen(Board::getOpponentColor(color));
+                uint32_t attackedSquares = 0;
+
+                for (int moveIter = 0; moveIter < opponentMoves.size(); moveIter++)
+                {
+                    if (opponentMoves.at(moveIter).removalSquare.size() > 0)
+                        attackedSquares |= 1U << (opponentMoves.at(moveIter).removalSquare.at(0) - 1);
+                }
+
+                listChecksum += attackedSquares;
+            }
+        }
+    }
+    auto t2 = high_resolution_clock::now();
+    duration<double, std::nano> listTime = t2 - t1;
+
+    t1 = high_resolution_clock::now();
+    for (int repeat = 0; repeat < numRepeats; repeat++)
+    {
+        for (size_t posIter = 0; posIter < positions.size(); posIter++)
+        {
+            maskChecksum += positions[posIter].getAttackedMask(Color::BLACK) + positions[posIter].getAttackedMask(Color::RED);
+        }
+    }
+    t2 = high_resolution_clock::now();
+    duration<double, std::nano> maskTime = t2 - t1;
+
+    t1 = high_resolution_clock::now();
+    for (int repeat = 0; repeat < numRepeats; repeat++)
+    {
+        for (size_t posIter = 0; posIter < positions.size(); posIter++)
+        {
+            hangingChecksum += positions[posIter].getHangingMask(Color::BLACK) + positions[posIter].getHangingMask(Color::RED);
+        }
+    }
+    t2 = high_resolution_clock::now();
+    duration<double, std::nano> hangingTime = t2 - t1;
+
+    long long numChecks = (long long)numRepeats * positions.size();
+
+    std::cout << "Attacked pieces, both colors, over " << positions.size() << " positions" << std::endl;
+    std::cout << "  from opponent moveGen(): " << listTime.count() / numChecks << " ns each"
+              << " (checksum " << listChecksum << ")" << std::endl;
+    std::cout << "  getAttackedMask(): " << maskTime.count() / numChecks << " ns each"
+              << " (checksum " << maskChecksum << ")" << std::endl;
+    std::cout << "  getHangingMask(): " << hangingTime.count() / numChecks << " ns each"
+              << " (checksum " << hangingChecksum << ")" << std::endl;
+}
+
+/**
+ * Times checking moves that did not come from the move generator, such as a move kept from an
+ * earlier search. At each position of a fixed game the candidates are the moves of that position
+ * and of the two positions before it with the same side to move, so some are legal and some are
+ * not. Each candidate is looked up in a freshly generated move list, as a search would have to
+ * do without Board::isLegal, and checked with Board::isLegal. The counts of legal moves agree.
+ */
+void Benchmark::runLegalityChecks()
+{
+    const int numPlies = 60;
+    const int numRepeats = 2000;
+    std::vector<Board> positions;
+    std::vector<Color> sidesToMove;
+    std::vector<std::vector<Board::PackedMove> > candidates;
+    long long listLegal = 0, maskLegal = 0, numCandidates = 0;
+
+    for (int ply = 0; ply < numPlies; ply++)
+    {
+        Color sideToMove;
+        positions.push_back(playFixedOpening(ply, sideToMove));
+        sidesToMove.push_back(sideToMove);
+    }
+
+    for (int posIter = 0; posIter < (int)positions.size(); posIter++)
+    {
+        candidates.push_back(std::vector<Board::PackedMove>());
+
+        for (int earlierIter = posIter; earlierIter >= 0 && earlierIter >= posIter - 4; earlierIter -= 2)
+        {
+            Board::MoveList moves = positions[earlierIter].moveGen(sidesToMove[earlierIter]);
+
+            for (int moveIter = 0; moveIter < moves.size(); moveIter++)
+                candidates[posIter].push_back(Board::packMove(moves.at(moveIter)));
+        }
+
+        numCandidates += candidates[posIter].size();
+    }
+
+    auto t1 = high_resolution_clock::now();
+    for (int repeat = 0; repeat < numRepeats; repeat++)
+    {
+        for (size_t posIter = 0; posIter < positions.size(); posIter++)
+        {
+            for (size_t candIter = 0; candIter < candidates[posIter].size(); candIter++)
+            {
+                Board::MoveList moves = positions[posIter].moveGen(sidesToMove[posIter]);
+
+                for (int moveIter = 0; moveIter < moves.size(); moveIter++)
+                {
+                    if (Board::packMove(moves.at(moveIter)) == candidates[posIter][candIter])
+                    {
+                        listLegal++;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+    auto t2 = high_resolution_clock::now();
+    duration<double, std::nano> listTime = t2 - t1;
+
+    t1 = high_resolution_clock::now();
+    for (int repeat = 0; repeat < numRepeats; repeat++)
+    {
+        for (size_t posIter = 0; posIter < positions.size(); posIter++)
+        {
+            for (size_t candIter = 0; candIter < candidates[posIter].size(); candIter++)
+            {
+                maskLegal += positions[posIter].isLegal(candidates[posIter][candIter], sidesToMove[posIter]);
+            }
+        }
+    }
+    t2 = high_resolution_clock::now();
+    duration<double, std::nano> maskTime = t2 - t1;
+
+    long long numChecks = (long long)numRepeats * numCandidates;
+
+    std::cout << "Stored move checks, " << numCandidates << " candidate moves over " << positions.size() << " positions"
+              << std::endl;
+    std::cout << "  search moveGen() list: " << listTime.count() / numChecks << " ns each"
+              << " (" << listLegal / numRepeats << " legal)" << std::endl;
+    std::cout << "  isLegal(): " << maskTime.count() / numChecks << " ns each"
+              << " (" << maskLegal / numRepeats << " legal)" << std::endl;
+}
+
+/**
+ * Searches two fixed positions with both algorithms at depths 6 to 12, once without a
+ * transposition table and once with a new one, and reports the nodes each search visited, how
+ * many of the table lookups found their position and how many of those settled the node. The
+ * second position is a king endgame, where the same positions come up by many move orders.
+ */
+void Benchmark::runTranspositionTable()
+{
+    std::string algs[2] = {"Alpha-Beta-Search", "Minimax-Alpha-Beta"};
+
+    std::cout << "Transposition table, eval " << SEARCH_EVAL_VERSION << ", " << TranspositionTable::DEFAULT_SIZE_MB
+              << " MB" << std::endl;
+
+    for (int posIter = 0; posIter < NUM_SEARCH_POSITIONS; posIter++)
+    {
+        Board position;
+        Board::parsePosition(SEARCH_POSITIONS[posIter], position);
+        Color sideToMove = position.getSideToMove();
+
+        std::cout << "  " << SEARCH_POSITIONS[posIter] << std::endl;
+
+        for (int depth = 6; depth <= 12; depth += 2)
+        {
+            for (int isMinimax = 0; isMinimax <= 1; isMinimax++)
+            {
+                long long numNodes[2];
+                double elapsedMs[2];
+                int tableProbes = 0, tableHits = 0, tableCutoffs = 0;
+
+                for (int useTable = 0; useTable <= 1; useTable++)
+                {
+                    Player player(isMinimax, sideToMove, depth, SEARCH_EVAL_VERSION);
+
+                    if (!useTable)
+                        player.setTranspositionTable(nullptr);
+
+                    Algorithm algorithm(SEARCH_EVAL_VERSION, depth, player);
+                    Board state = position;
+
+                    algorithm.reduceLateMoves = false;
+
+                    auto t1 = high_resolution_clock::now();
+                    if (isMinimax)
+                        algorithm.minimax_a_b(state, depth, sideToMove, 9000000, -8000000);
+                    else
+                        algorithm.alphaBetaSearch(state);
+                    auto t2 = high_resolution_clock::now();
+                    duration<double, std::milli> elapsed = t2 - t1;
+
+                    numNodes[useTable] = isMinimax ? algorithm.minimaxExpandedNodes + algorithm.minimaxLeafNodes
+                                                   : algorithm.absearchExpandedNodes + algorithm.absearchLeafNodes;
+                    elapsedMs[useTable] = elapsed.count();
+                    tableProbes = algorithm.tableProbes;
+                    tableHits = algorithm.tableHits;
+                    tableCutoffs = algorithm.tableCutoffs;
+                }
+
+                std::cout << "    depth " << depth << " " << algs[isMinimax] << ": nodes " << numNodes[0] << " -> "
+                          << numNodes[1] << " (" << 100.0 * (numNodes[0] - numNodes[1]) / numNodes[0] << "% fewer), "
+                          << elapsedMs[0] << " -> " << elapsedMs[1] << " ms, hits "
+                          << 100.0 * tableHits / (tableProbes > 0 ? tableProbes : 1) << "% of " << tableProbes
+                          << " probes, " << tableCutoffs << " cutoffs" << std::endl;
+            }
+        }
+    }
+}
+
+/**
+ * Searches the positions of runTranspositionTable with both algorithms at depths 6 to 10, once
+ * with moves in generation order and once ordered, both with a transposition table. Reports the
+ * nodes each search visited and the share of cutoffs that came on the first move tried, which is
+ * how close the ordering gets to trying the best move first.
+ */
+void Benchmark::runMoveOrdering()
+{
+    std::string algs[2] = {"Alpha-Beta-Search", "Minimax-Alpha-Beta"};
+
+    std::cout << "Move ordering, eval " << SEARCH_EVAL_VERSION << std::endl;
+
+    for (int posIter = 0; posIter < NUM_SEARCH_POSITIONS; posIter++)
+    {
+        Board position;
+        Board::parsePosition(SEARCH_POSITIONS[posIter], position);
+        Color sideToMove = position.getSideToMove();
+
+        std::cout << "  " << SEARCH_POSITIONS[posIter] << std::endl;
+
+        for (int depth = 6; depth <= 10; depth += 2)
+        {
+            for (int isMinimax = 0; isMinimax <= 1; isMinimax++)
+            {
+                long long numNodes[2];
+                double elapsedMs[2];
+                double firstMovePercent[2];
+
+                for (int orderMoves = 0; orderMoves <= 1; orderMoves++)
+                {
+                    Player player(isMinimax, sideToMove, depth, SEARCH_EVAL_VERSION);
+                    Algorithm algorithm(SEARCH_EVAL_VERSION, depth, player);
+                    Board state = position;
+
+                    algorithm.orderMoves = orderMoves;
+                    algorithm.reduceLateMoves = false;
+
+                    auto t1 = high_resolution_clock::now();
+                    if (isMinimax)
+                        algorithm.minimax_a_b(state, depth, sideToMove, 9000000, -8000000);
+                    else
+                        algorithm.alphaBetaSearch(state);
+                    auto t2 = high_resolution_clock::now();
+                    duration<double, std::milli> elapsed = t2 - t1;
+
+                    numNodes[orderMoves] = isMinimax ? algorithm.minimaxExpandedNodes + algorithm.minimaxLeafNodes
+                                                     : algorithm.absearchExpandedNodes + algorithm.absearchLeafNodes;
+                    elapsedMs[orderMoves] = elapsed.count();
+                    firstMovePercent[orderMoves] =
+                        100.0 * algorithm.firstMoveCutoffs / (algorithm.betaCutoffs > 0 ? algorithm.betaCutoffs : 1);
+                }
+
+                std::cout << "    depth " << depth << " " << algs[isMinimax] << ": nodes " << numNodes[0] << " -> "
+                          << numNodes[1] << " (" << 100.0 * (numNodes[0] - numNodes[1]) / numNodes[0] << "% fewer), "
+                          << elapsedMs[0] << " -> " << elapsedMs[1] << " ms, first move cutoffs "
+                          << firstMovePercent[0] << "% -> " << firstMovePercent[1] << "%" << std::endl;
+            }
+        }
+    }
+}
+
+/**
+ * Searches the positions of runTranspositionTable at even depths 6 to 12 with alphaBetaSearch,
+ * with principalVariationSearch using full windows only, which is plain negamax alpha-beta, and
+ * with principalVariationSearch, each with a new transposition table. Reports the nodes and time
+ * of each, how many moves PVS had to search again after a null window, and how PVS compares with
+ * alphaBetaSearch. The two negamax searches must agree on the value. alphaBetaSearch can score a
+ * position differently, since minValue scores its leaves for the player to move there; where the
+ * values differ the two searched different trees, so their nodes are not compared.
+ *
+ * Each position is then searched the way Player does, deepening one ply at a time to depth 12 with
+ * one table, which is where PVS gets the hash moves its null windows rely on.
+ */
+void Benchmark::runPrincipalVariation()
+{
+
+    std::cout << "Principal Variation Search, eval " << SEARCH_EVAL_VERSION << std::endl;
+
+    for (int posIter = 0; posIter < NUM_SEARCH_POSITIONS; posIter++)
+    {
+        Board position;
+        Board::parsePosition(SEARCH_POSITIONS[posIter], position);
+        Color sideToMove = position.getSideToMove();
+
+        std::cout << "  " << SEARCH_POSITIONS[posIter] << std::endl;
+
+        for (int depth = 6; depth <= 12; depth += 2)
+        {
+            // alphaBetaSearch, negamax with full windows, Principal Variation Search
+            std::string searches[3] = {"Alpha-Beta-Search", "negamax", "PVS"};
+            long long numNodes[3];
+            double elapsedMs[3];
+            int values[3];
+            int numResearches = 0;
+
+            for (int searchIter = 0; searchIter < 3; searchIter++)
+            {
+                Player player(false, sideToMove, depth, SEARCH_EVAL_VERSION);
+                Algorithm algorithm(SEARCH_EVAL_VERSION, depth, player);
+                algorithm.reduceLateMoves = false;
+                algorithm.nullWindows = (searchIter == 2);
+
+                auto t1 = high_resolution_clock::now();
+                Algorithm::Result result = (searchIter > 0) ? algorithm.principalVariationSearch(position)
+                                                            : algorithm.alphaBetaSearch(position);
+                auto t2 = high_resolution_clock::now();
+                duration<double, std::milli> elapsed = t2 - t1;
+
+                numNodes[searchIter] = algorithm.absearchExpandedNodes + algorithm.absearchLeafNodes;
+                elapsedMs[searchIter] = elapsed.count();
+                values[searchIter] = result.value;
+                numResearches = algorithm.nullWindowResearches;
+            }
+
+            std::cout << "    depth " << depth << ":";
+            for (int searchIter = 0; searchIter < 3; searchIter++)
+                std::cout << " " << searches[searchIter] << " " << numNodes[searchIter] << " nodes "
+                          << elapsedMs[searchIter] << " ms" << (searchIter < 2 ? "," : "");
+            std::cout << " (" << numResearches << " re-searched), value " << values[2]
+                      << (values[1] == values[2] ? "" : " DIFFERENT from negamax") << std::endl;
+
+            std::cout << "      PVS " << 100.0 * (numNodes[1] - numNodes[2]) / numNodes[1] << "% fewer than negamax, ";
+            if (values[0] == values[2])
+                std::cout << 100.0 * (numNodes[0] - numNodes[2]) / numNodes[0] << "% fewer than Alpha-Beta" << std::endl;
+            else
+                std::cout << "not compared with Alpha-Beta, which scores it " << values[0] << std::endl;
+        }
+
+        long long numDeepenedNodes[2] = {0, 0};
+        double deepenedMs[2] = {0, 0};
+        int deepenedValues[2];
+
+        for (int isNegamax = 0; isNegamax <= 1; isNegamax++)
+        {
+            Player player(false, sideToMove, 12, SEARCH_EVAL_VERSION);
+
+            for (int depth = 1; depth <= 12; depth++)
+            {
+                Algorithm algorithm(SEARCH_EVAL_VERSION, depth, player);
+                algorithm.reduceLateMoves = false;
+
+                auto t1 = high_resolution_clock::now();
+                Algorithm::Result result = isNegamax ? algorithm.principalVariationSearch(position)
+                                                     : algorithm.alphaBetaSearch(position);
+                auto t2 = high_resolution_clock::now();
+                duration<double, std::milli> elapsed = t2 - t1;
+
+                deepenedValues[isNegamax] = result.value;
+                numDeepenedNodes[isNegamax] += algorithm.absearchExpandedNodes + algorithm.absearchLeafNodes;
+                deepenedMs[isNegamax] += elapsed.count();
+            }
+        }
+
+        std::cout << "    deepening to 12: Alpha-Beta-Search " << numDeepenedNodes[0] << " nodes " << deepenedMs[0]
+                  << " ms, PVS " << numDeepenedNodes[1] << " nodes " << deepenedMs[1] << " ms, ";
+        if (deepenedValues[0] == deepenedValues[1])
+            std::cout << 100.0 * (numDeepenedNodes[0] - numDeepenedNodes[1]) / numDeepenedNodes[0] << "% fewer" << std::endl;
+        else
+            std::cout << "values differ, not compared" << std::endl;
+    }
+}
+
+/**
+ * For each evaluation function, searches positions of a fixed opening to depth 8 with
+ * alphaBetaSearch and principalVariationSearch, once with the widest root window and once with an
+ * aspiration window around the score of a depth 6 search, as iterative deepening would have it.
+ * Reports the nodes of each and how often the window had to be widened, which is what the window
+ * sizes of Algorithm::getDefaultAspirationWindow are tuned by.
+ */
+void Benchmark::runAspirationWindows()
+{
+    const int depth = 8;
+    std::string algs[2] = {"Alpha-Beta-Search", "PVS"};
+
+    std::cout << "Aspiration windows, depth " << depth << " around depth " << depth - 2 << std::endl;
+
+    for (int evalVersion = 1; evalVersion <= 3; evalVersion++)
+    {
+        for (int isNegamax = 0; isNegamax <= 1; isNegamax++)
+        {
+            long long numNodes[2] = {0, 0};
+            int numSame = 0, numSearches = 0, failLows = 0, failHighs = 0;
+
+            for (int openingPlies = 0; openingPlies <= 30; openingPlies += 5)
+            {
+                Color sideToMove;
+                Board state = playFixedOpening(openingPlies, sideToMove);
+                Player player(false, sideToMove, depth, evalVersion);
+                Algorithm shallowSearch(evalVersion, depth - 2, player);
+                shallowSearch.reduceLateMoves = false;
+                int expectedValue = isNegamax ? shallowSearch.principalVariationSearch(state).value
+                                              : shallowSearch.alphaBetaSearch(state).value;
+                int values[2];
+
+                for (int useWindow = 0; useWindow <= 1; useWindow++)
+                {
+                    // a new table each time, so the first search does not help the second
+                    player.setTranspositionTable(std::make_shared<TranspositionTable>());
+                    Algorithm algorithm(evalVersion, depth, player);
+                    algorithm.reduceLateMoves = false;
+
+                    if (useWindow)
+                        algorithm.setExpectedValue(expectedValue);
+
+                    values[useWindow] = isNegamax ? algorithm.principalVariationSearch(state).value
+                                                  : algorithm.alphaBetaSearch(state).value;
+                    numNodes[useWindow] += algorithm.absearchExpandedNodes + algorithm.absearchLeafNodes;
+                    failLows += algorithm.aspirationFailLows;
+                    failHighs += algorithm.aspirationFailHighs;
+                }
+
+                numSearches++;
+                if (values[0] == values[1])
+                    numSame++;
+            }
+
+            std::cout << "  eval " << evalVersion << ", window " << Algorithm::getDefaultAspirationWindow(evalVersion)
+                      << ", " << algs[isNegamax] << ": nodes " << numNodes[0] << " -> " << numNodes[1] << " ("
+                      << 100.0 * (numNodes[0] - numNodes[1]) / numNodes[0] << "% fewer), widened " << failLows
+                      << " times low and " << failHighs << " high in " << numSearches << " searches, " << numSame
+                      << " same values" << std::endl;
+        }
+    }
+}
+
+/**
+ * Searches positions of a fixed opening with principalVariationSearch at depths 2 to 8, with and
+ * without quiescence, and compares each with a depth 10 search of the same position. Reports the
+ * nodes searched, quiescence nodes included, how many moves agree with the deep search, and how
+ * far the scores are from the deep one on average. A search whose scores and moves are as good
+ * with fewer nodes plays as well for less.
+ */
+void Benchmark::runQuiescence()
+{
+    const int evalVersion = 1;
+    const int referenceDepth = 10;
+    std::vector<Board> positions;
+    std::vector<Algorithm::Result> references;
+
+    for (int openingPlies = 0; openingPlies <= 30; openingPlies += 2)
+    {
+        Color sideToMove;
+        positions.push_back(playFixedOpening(openingPlies, sideToMove));
+
+        Player player(false, sideToMove, referenceDepth, evalVersion);
+        Algorithm algorithm(evalVersion, referenceDepth, player);
+        algorithm.reduceLateMoves = false;
+        references.push_back(algorithm.principalVariationSearch(positions.back()));
+    }
+
+    std::cout << "Quiescence, PVS, eval " << evalVersion << ", against depth " << referenceDepth << " over "
+              << positions.size() << " positions" << std::endl;
+
+    for (int depth = 2; depth <= 8; depth += 2)
+    {
+        std::cout << "  depth " << depth << ":";
+
+        for (int useQuiescence = 0; useQuiescence <= 1; useQuiescence++)
+        {
+            long long numNodes = 0, scoreError = 0;
+            int numSameMoves = 0;
+
+            for (size_t posIter = 0; posIter < positions.size(); posIter++)
+            {
+                Player player(false, positions[posIter].getSideToMove(), depth, evalVersion);
+                Algorithm algorithm(evalVersion, depth, player);
+                algorithm.reduceLateMoves = false;
+                algorithm.useQuiescence = useQuiescence;
+
+                Algorithm::Result result = algorithm.principalVariationSearch(positions[posIter]);
+
+                numNodes += algorithm.absearchExpandedNodes + algorithm.absearchLeafNodes + algorithm.quiescenceNodes;
+                scoreError += std::abs((long long)result.value - references[posIter].value);
+                if (result.bestMove == references[posIter].bestMove)
+                    numSameMoves++;
+            }
+
+            std::cout << (useQuiescence ? "; quiescence " : " plain ") << numNodes << " nodes, " << numSameMoves
+                      << " same moves, score off by " << scoreError / (long long)positions.size();
+        }
+
+        std::cout << std::endl;
+    }
+}
+
+/**
+ * Deepens the search of each position of a fixed opening one ply at a time up to depth 10, the way
+ * Player does, with one transposition table per position and an aspiration window around the
+ * score from two plies before. Does so with alphaBetaSearch and principalVariationSearch, with and
+ * without late move reductions, and reports the total time taken to get to depths 6, 8 and 10,
+ * the nodes searched, how many moves were reduced and re-searched, and how many depth 10 moves
+ * match the search without reductions.
+ */
+void Benchmark::runTimeToDepth()
+{
+    const int evalVersion = 1;
+    const int maxDepth = 10;
+    std::string algs[2] = {"Alpha-Beta-Search", "PVS"};
+
+    std::cout << "Time to depth, eval " << evalVersion << ", iterative deepening to depth " << maxDepth << std::endl;
+
+    for (int isNegamax = 0; isNegamax <= 1; isNegamax++)
+    {
+        std::vector<Board::PackedMove> fullDepthMoves;
+
+        for (int reduceLateMoves = 0; reduceLateMoves <= 1; reduceLateMoves++)
+        {
+            double elapsedMs[maxDepth + 1] = {0};
+            long long numNodes = 0, numReductions = 0, numResearches = 0;
+            int numPositions = 0, numSameMoves = 0;
+
+            for (int openingPlies = 0; openingPlies <= 30; openingPlies += 2)
+            {
+                Color sideToMove;
+                Board state = playFixedOpening(openingPlies, sideToMove);
+                Player player(false, sideToMove, maxDepth, evalVersion);
+                int values[maxDepth + 1];
+                Algorithm::Result result;
+
+                for (int depth = 1; depth <= maxDepth; depth++)
+                {
+                    Algorithm algorithm(evalVersion, depth, player);
+                    algorithm.reduceLateMoves = reduceLateMoves;
+
+                    if (depth > 2)
+                        algorithm.setExpectedValue(values[depth - 2]);
+
+                    auto t1 = high_resolution_clock::now();
+                    result = isNegamax ? algorithm.principalVariationSearch(state) : algorithm.alphaBetaSearch(state);
+                    auto t2 = high_resolution_clock::now();
+                    duration<double, std::milli> elapsed = t2 - t1;
+
+                    values[depth] = result.value;
+                    elapsedMs[depth] += elapsed.count();
+                    numNodes += algorithm.absearchExpandedNodes + algorithm.absearchLeafNodes + algorithm.quiescenceNodes;
+                    numReductions += algorithm.lateMoveReductions;
+                    numResearches += algorithm.lateMoveResearches;
+                }
+
+                if (!reduceLateMoves)
+                    fullDepthMoves.push_back(result.bestMove);
+                else if (result.bestMove == fullDepthMoves[numPositions])
+                    numSameMoves++;
+
+                numPositions++;
+            }
+
+            for (int depth = 2; depth <= maxDepth; depth++)
+                elapsedMs[depth] += elapsedMs[depth - 1];
+
+            std::cout << "  " << algs[isNegamax] << (reduceLateMoves ? ", reduced: " : ", full depth: ") << "depth 6 "
+                      << elapsedMs[6] << " ms, depth 8 " << elapsedMs[8] << " ms, depth " << maxDepth << " "
+                      << elapsedMs[maxDepth] << " ms, " << numNodes << " nodes";
+            if (reduceLateMoves)
+                std::cout << ", " << numReductions << " reductions, " << numResearches << " re-searched, "
+                          << numSameMoves << " of " << numPositions << " same moves";
+            std::cout << std::endl;
+        }
+    }
+}
+
+/**
+ * Walks every move sequence up to depth plies from state, adding the hash key and canonical hash
+ * key of each position reached, state included.
+ *
+ * @param Board &state - the position to walk from; it is unchanged on return
+ * @param int depth - how many plies to walk
+ * @param std::unordered_set<uint64_t> &keys - receives the hash keys
+ * @param std::unordered_set<uint64_t> &canonicalKeys - receives the canonical hash keys
+ */
+void Benchmark::collectKeys(Board &state, int depth, std::unordered_set<uint64_t> &keys,
+                            std::unordered_set<uint64_t> &canonicalKeys)
+{
+    bool isFlipped;
+
+    keys.insert(state.getHashKey());
+    canonicalKeys.insert(state.getCanonicalHashKey(isFlipped));
+
+    if (depth == 0)
+        return;
+
+    Color color = state.getSideToMove();
+    Board::MoveList moves = state.moveGen(color);
+
+    for (int moveIter = 0; moveIter < moves.size(); moveIter++)
+    {
+        Board::PackedMove move = Board::packMove(moves.at(moveIter));
+        Board::Undo undo;
+
+        state.makeMove(move, color, undo);
+        collectKeys(state, depth - 1, keys, canonicalKeys);
+        state.unmakeMove(move, color, undo);
+    }
+}
+
+/**
+ * Sets up a random endgame: four kings for the side to move against three kings and seven men. The
+ * position is written as text and read back by Board::parsePosition, which rejects a man left on
+ * its kinging row, so squares are drawn until a valid position comes out.
+ *
+ * @param unsigned long long &seed - random state, advanced on return
+ *
+ * @return Board - the endgame
+ */
+Board Benchmark::makeKingEndgame(unsigned long long &seed)
+{
+    Board board;
+    bool isValid = false;
+
+    while (!isValid)
+    {
+        uint32_t usedSquares = 0;
+        int squares[14];
+
+        for (int pieceIter = 0; pieceIter < 14; pieceIter++)
+        {
+            do
+            {
+                seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+                squares[pieceIter] = (int)((seed >> 33) % 32) + 1;
+            } while (usedSquares & (1U << (squares[pieceIter] - 1)));
+
+            usedSquares |= 1U << (squares[pieceIter] - 1);
+        }
+
+        // Pieces 0 - 3 are the kings of the side to move, 4 - 6 the opposing kings and 7 - 13 its men
+        bool isRedToMove = (seed >> 20) & 1;
+        std::string playerText, opponentText;
+
+        for (int pieceIter = 0; pieceIter < 14; pieceIter++)
+        {
+            std::string &text = (pieceIter < 4) ? playerText : opponentText;
+            text += (text.empty() ? "" : ",") + std::string(pieceIter < 7 ? "K" : "") + std::to_string(squares[pieceIter]);
+        }
+
+        std::string position = std::string(isRedToMove ? "R" : "B") + ":R" + (isRedToMove ? playerText : opponentText) +
+                               ":B" + (isRedToMove ? opponentText : playerText);
+
+        isValid = Board::parsePosition(position, board);
+    }
+
+    return board;
+}
+
+/**
+ * Plays numPlies moves from the initial board, Black first as in a Game. Moves are chosen
+ * by a fixed pattern rather than by a search, so the resulting position never changes.
+ *
+ * @param int numPlies - how many moves to play
+ * @param Color &sideToMove - returns the color to move in the resulting position
+ *
+ * @return Board - the position reached
+ */
+Board Benchmark::playFixedOpening(int numPlies, Color &sideToMove)
+{
+    Board board;
+    sideToMove = Color::BLACK;
+
+    for (int ply = 0; ply < numPlies; ply++)
+    {
+        Board::MoveList moves = board.moveGen(sideToMove);
+
+        if (moves.size() == 0)
+            break;
+
+        board = board.updateBoard(moves.at((ply * 7) % moves.size()), sideToMove);
+        sideToMove = (sideToMove == Color::RED) ? Color::BLACK : Color::RED;
+    }
+
+    return board;
+}
@@ -1,92 +1,237 @@
 #include "Board.hpp"
 #include "Pieces.hpp"
+#include <cassert>
 #include <iostream>
 #include <iomanip>
 
-// Forward declare the static data member.
-Board::BoardMoveTable Board::boardMoveTable[33];
+/**
+ * Member Function | Board | getSquareAt
+ *
+ * Summary :	Finds the playable square at a row and column of the
+ *				8 x 8 grid, both counted from 0 at the top left. Only
+ *				dark squares are playable, so each row holds four of the
+ *				32 squares. Used at compile time to build the move table.
+ *
+ * @param int row		: The grid row, 0 - 7.
+ * @param int column	: The grid column, 0 - 7.
+ *
+ * @return int : The square, 1 - 32, or 0 if off the board.
+ *
+ */
+constexpr int Board::getSquareAt(int row, int column)
+{
+	return (row < 0 || row > 7 || column < 0 || column > 7) ? 0 : row * 4 + column / 2 + 1;
+}
 
 /**
-  * Constructor | Board | Board
-  * 
-  * Summary	: Creates both the red player and black player
-  *				 piece list. If not already done, it also
-  *				instantiates the static move table.
-  *
-  * @author : David Torrente
-  * 
-  */
-Board::Board()
+ * Member Function | Board | getDiagonalSquare
+ *
+ * Summary :	Finds the square a number of diagonal steps away from
+ *				another square. Squares 1 - 4, 9 - 12 and so on sit in
+ *				the odd grid columns, the rows in between in the even ones.
+ *
+ * @param int square	: The square to step from, 1 - 32.
+ * @param int direction	: UP_LEFT, UP_RIGHT, DOWN_LEFT or DOWN_RIGHT.
+ * @param int distance	: The number of steps, 1 for a move and 2 for a jump.
+ *
+ * @return int : The square, 1 - 32, or 0 if off the board.
+ *
+ */
+constexpr int Board::getDiagonalSquare(int square, int direction, int distance)
 {
-	// Guarded internally to prevent from having moves added to it.
-	InitializeMoveTable();
+	return square == 0 ? 0 : getSquareAt((square - 1) / 4 + (direction < DOWN_LEFT ? -distance : distance),
+										 2 * ((square - 1) % 4) + (((square - 1) / 4) % 2 == 0 ? 1 : 0) +
+											 (direction % 2 == 0 ? -distance : distance));
+}
 
-	// Assign the proper pieces to the player, either red or black.
-	redPieces = Pieces(Color::RED);
-	blackPieces = Pieces(Color::BLACK);
+/**
+ * Member Function | Board | getSquareBit
+ *
+ * Summary :	Gives the bit used for a square in the piece bit fields.
+ *
+ * @param int square	: The square, 1 - 32, or 0 for none.
+ *
+ * @return uint32_t : The bit for the square, or 0 for none.
+ *
+ */
+constexpr uint32_t Board::getSquareBit(int square)
+{
+	return square == 0 ? 0 : (uint32_t)1 << (square - 1);
 }
 
 /**
- * Destructor | Board | ~Board
+ * Member Function | Board | makeMoveTableEntry
+ *
+ * Summary :	Builds the move table entry for one square from the board
+ *				geometry. A jump passes over the square one step away in
+ *				the same direction, and only exists if it lands on the board.
+ *
+ * @param int square	: The square to build the entry for.
+ *
+ * @return BoardMoveTable : The moves, jumps and removals for the square.
  *
- * Summary : Class destructor. No special code required.
- * 
- * @author : David Torrente
- * 
  */
-Board::~Board()
+constexpr Board::BoardMoveTable Board::makeMoveTableEntry(int square)
 {
+	return BoardMoveTable{
+		{getDiagonalSquare(square, UP_LEFT, 1), getDiagonalSquare(square, UP_RIGHT, 1),
+		 getDiagonalSquare(square, DOWN_LEFT, 1), getDiagonalSquare(square, DOWN_RIGHT, 1)},
+		{getDiagonalSquare(square, UP_LEFT, 2), getDiagonalSquare(square, UP_RIGHT, 2),
+		 getDiagonalSquare(square, DOWN_LEFT, 2), getDiagonalSquare(square, DOWN_RIGHT, 2)},
+		{getDiagonalSquare(square, UP_LEFT, 2) != 0 ? getDiagonalSquare(square, UP_LEFT, 1) : 0,
+		 getDiagonalSquare(square, UP_RIGHT, 2) != 0 ? getDiagonalSquare(square, UP_RIGHT, 1) : 0,
+		 getDiagonalSquare(square, DOWN_LEFT, 2) != 0 ? getDiagonalSquare(square, DOWN_LEFT, 1) : 0,
+		 getDiagonalSquare(square, DOWN_RIGHT, 2) != 0 ? getDiagonalSquare(square, DOWN_RIGHT, 1) : 0},
+		getSquareBit(getDiagonalSquare(square, UP_LEFT, 1)) | getSquareBit(getDiagonalSquare(square, UP_RIGHT, 1)) |
+			getSquareBit(getDiagonalSquare(square, DOWN_LEFT, 1)) | getSquareBit(getDiagonalSquare(square, DOWN_RIGHT, 1)),
+		getSquareBit(getDiagonalSquare(square, UP_LEFT, 2)) | getSquareBit(getDiagonalSquare(square, UP_RIGHT, 2)) |
+			getSquareBit(getDiagonalSquare(square, DOWN_LEFT, 2)) | getSquareBit(getDiagonalSquare(square, DOWN_RIGHT, 2))};
 }
 
+// The move table is a move guide for each square, not a piece tracker.
+// It is worked out by the compiler, so nothing runs to set it up and
+// boards can be created without touching it. Square 0 is unused.
+constexpr Board::BoardMoveTable Board::boardMoveTable[33] = {
+	makeMoveTableEntry(0), makeMoveTableEntry(1), makeMoveTableEntry(2), makeMoveTableEntry(3),
+	makeMoveTableEntry(4), makeMoveTableEntry(5), makeMoveTableEntry(6), makeMoveTableEntry(7),
+	makeMoveTableEntry(8), makeMoveTableEntry(9), makeMoveTableEntry(10), makeMoveTableEntry(11),
+	makeMoveTableEntry(12), makeMoveTableEntry(13), makeMoveTableEntry(14), makeMoveTableEntry(15),
+	makeMoveTableEntry(16), makeMoveTableEntry(17), makeMoveTableEntry(18), makeMoveTableEntry(19),
+	makeMoveTableEntry(20), makeMoveTableEntry(21), makeMoveTableEntry(22), makeMoveTableEntry(23),
+	makeMoveTableEntry(24), makeMoveTableEntry(25), makeMoveTableEntry(26), makeMoveTableEntry(27),
+	makeMoveTableEntry(28), makeMoveTableEntry(29), makeMoveTableEntry(30), makeMoveTableEntry(31),
+	makeMoveTableEntry(32)};
+
+static_assert(Board::boardMoveTable[1].moveMask == ((1 << 4) | (1 << 5)) && Board::boardMoveTable[10].removals[Board::UP_LEFT] == 6,
+			  "the move table does not match the board layout");
+
 /**
- * Member Function | Board | getPlayerPieces
+ * Member Function | Board | mixZobristBits, getZobristKey
  *
- * Summary :	Gets the pieces that belong to a particular player. 
+ * Summary :	Give the random key with a given index. It is the splitmix64
+ *				generator evaluated at that index, so each key depends on
+ *				its index alone and can be worked out at compile time.
+ *				mixZobristBits is one of the generator's mixing steps.
  *
- * @author : David Torrente
- * 
- * @param Color color :	 The player color of pieces to get.
+ * @param uint64_t index	: The key index. 0 is the side key, and each square
+ *							  has two keys after it, a red man and a red king.
+ *
+ * @return uint64_t : The key.
  *
- * @return Pieces :	The pieces belonging to the player.
- * 
  */
-Pieces Board::getPlayerPieces(Color color)
+constexpr uint64_t Board::mixZobristBits(uint64_t bits, int shift, uint64_t multiplier)
 {
-	if (color == Color::RED)
-	{
-		return redPieces;
-	}
-	else
-	{
-		return blackPieces;
-	}
+	return (bits ^ (bits >> shift)) * multiplier;
+}
+
+constexpr uint64_t Board::getZobristKey(uint64_t index)
+{
+	return mixZobristBits(mixZobristBits(mixZobristBits((index + 1) * 0x9E3779B97F4A7C15ULL, 30, 0xBF58476D1CE4E5B9ULL),
+										 27, 0x94D049BB133111EBULL),
+						  31, 1);
 }
 
 /**
- * Member Function | Board | getOpponentPieces
+ * Member Function | Board | swapKeyHalves, makeZobristEntry
  *
- * Summary :	Gets the pieces that belong to the 
- *				opposing player.
+ * Summary :	Give the keys of the four pieces that can stand on a square.
+ *				Red keys are random. A black piece's key is the key of the
+ *				red piece on the square opposite, 33 - square, with its two
+ *				32 bit halves swapped. Swapping colors and turning the board
+ *				around moves every piece to exactly such a square, so the
+ *				key of the flipped board is the key of the board with its
+ *				halves swapped. See getCanonicalHashKey.
  *
- * @author : David Torrente
- * 
- * @param Color color :	 The player color of pieces to
- *						 get the opponent of.
+ * @param int square	: The square, 1 - 32.
  *
- * @return Pieces :	The pieces belonging to the 
- *						opposing player.
+ * @return ZobristKeys : The keys for the square.
  *
  */
-Pieces Board::getOpponentPieces(Color color)
+constexpr uint64_t Board::swapKeyHalves(uint64_t key)
 {
-	if (color == Color::RED)
-	{
-		return blackPieces;
-	}
-	else
-	{
-		return redPieces;
-	}
+	return (key << 32) | (key >> 32);
+}
+
+constexpr Board::ZobristKeys Board::makeZobristEntry(int square)
+{
+	return ZobristKeys{{getZobristKey(square * 2 + 1), swapKeyHalves(getZobristKey((33 - square) * 2 + 1))},
+					   {getZobristKey(square * 2 + 2), swapKeyHalves(getZobristKey((33 - square) * 2 + 2))}};
+}
+
+// The Zobrist keys, one entry per square like the move table. Square 0 is unused.
+constexpr Board::ZobristKeys Board::zobristKeys[33] = {
+	makeZobristEntry(0), makeZobristEntry(1), makeZobristEntry(2), makeZobristEntry(3),
+	makeZobristEntry(4), makeZobristEntry(5), makeZobristEntry(6), makeZobristEntry(7),
+	makeZobristEntry(8), makeZobristEntry(9), makeZobristEntry(10), makeZobristEntry(11),
+	makeZobristEntry(12), makeZobristEntry(13), makeZobristEntry(14), makeZobristEntry(15),
+	makeZobristEntry(16), makeZobristEntry(17), makeZobristEntry(18), makeZobristEntry(19),
+	makeZobristEntry(20), makeZobristEntry(21), makeZobristEntry(22), makeZobristEntry(23),
+	makeZobristEntry(24), makeZobristEntry(25), makeZobristEntry(26), makeZobristEntry(27),
+	makeZobristEntry(28), makeZobristEntry(29), makeZobristEntry(30), makeZobristEntry(31),
+	makeZobristEntry(32)};
+
+constexpr uint64_t Board::zobristRedToMove = getZobristKey(0);
+
+/**
+ * Member Function | Board | getInitialHashKey
+ *
+ * Summary :	Works out the hash key of the initial board at compile time,
+ *				from the given square up to square 32. Red men stand on
+ *				1 - 12 and black men on 21 - 32, and black is to move.
+ *
+ * @param int square	: The first square to include.
+ *
+ * @return uint64_t : The XOR of the keys of the pieces on those squares.
+ *
+ */
+constexpr uint64_t Board::getInitialHashKey(int square)
+{
+	return square > 32 ? 0
+					   : ((square <= 12 ? zobristKeys[square].men[0] : 0) ^ (square >= 21 ? zobristKeys[square].men[1] : 0) ^
+						  getInitialHashKey(square + 1));
+}
+
+constexpr uint64_t Board::INITIAL_HASH_KEY = getInitialHashKey(1);
+
+// Keys are stored in on-disk tables, so they must never change. If this
+// fails, the key generation has been changed.
+static_assert(Board::zobristRedToMove == 0xE220A8397B1DCDAFULL && Board::zobristKeys[1].men[0] == 0xF88BB8A8724C81ECULL,
+			  "the Zobrist keys have changed");
+
+/**
+  * Constructor | Board | Board
+  * 
+  * Summary	: Sets up the initial board, red on squares 1 - 12 and
+  *				 black on squares 21 - 32, with black to move.
+  *
+  * @author : David Torrente
+  * 
+  */
+Board::Board()
+	: redSquares(RED_START_MASK), blackSquares(BLACK_START_MASK), kings(0), sideToMove(Color::BLACK),
+	  hashKey(INITIAL_HASH_KEY)
+{
+}
+
+/**
+ * Member Function | Board | getPiecesMask, getKingsMask
+ *
+ * Summary :	Gets the squares of every piece of a player, and of its
+ *				kings only.
+ *
+ * @param Color color :	 The player color of pieces to get.
+ *
+ * @return uint32_t :	A bit field, bit 0 being square 1.
+ * 
+ */
+uint32_t Board::getPiecesMask(Color color) const
+{
+	return (color == Color::RED) ? redSquares : blackSquares;
+}
+
+uint32_t Board::getKingsMask(Color color) const
+{
+	return getPiecesMask(color) & kings;
 }
 
 /**
@@ -126,30 +271,7 @@ int Board::getNumRegularPieces(Color color)
  */
 int Board::getNumKingPieces(Color color)
 {
-	{
-		int kingPieceCount = 0;
-
-		long long *playerPieces;
-
-		if (color == Color::RED)
-		{
-			playerPieces = &redPieces.pieces;
-		}
-		else
-		{
-			playerPieces = &blackPieces.pieces;
-		}
-
-		for (int iter = 32; iter < 64; iter++)
-		{
-			if (((*playerPieces >> iter) & 1) == 1)
-			{
-				kingPieceCount++;
-			}
-		}
-
-		return kingPieceCount;
-	}
+	return __builtin_popcount(getKingsMask(color));
 }
 
 /**
@@ -169,29 +291,7 @@ int Board::getNumKingPieces(Color color)
  */
 int Board::getNumPlayerTotalPieces(Color color)
 {
-	int totalPieceCount = 0;
-
-	long long *playerPieces;
-
-	if (color == Color::RED)
-	{
-		playerPieces = &redPieces.pieces;
-	}
-	else
-	{
-		playerPieces = &blackPieces.pieces;
-	}
-
-	for (int iter = 0; iter < 32; iter++)
-	{
-
-		if (((*playerPieces >> iter) & 1) == 1)
-		{
-			totalPieceCount++;
-		}
-	}
-
-	return totalPieceCount;
+	return __builtin_popcount(getPiecesMask(color));
 }
 
 /**
@@ -209,325 +309,639 @@ int Board::getNumPlayerTotalPieces(Color color)
  *
  * @param Color color :			The player color to get the moves
  *								for.
+ *
+ * @param bool collapseDuplicateCaptures :	If true, a king's jump routes
+ *								that take the same pieces and end on the
+ *								same square are listed once, as the first
+ *								such route. See getJumpsForPiece.
  * 
- * @return vector<Board::Move> :	A vector of possible moves
- *									for the player.
+ * @return MoveList :			A list of possible moves
+ *								for the player.
  *
  */
-std::vector<Board::Move> Board::moveGen(Color color)
+Board::MoveList Board::moveGen(Color color, bool collapseDuplicateCaptures)
 {
-	std::vector<Move> totalMoves;
-	std::vector<Move> returnedMoves;
-
-	Pieces *playerPieces;
-	Pieces *opponentPieces;
-
-	int bitOffset = 0;
-
+	// The color is decided once here; the generation below it is
+	// compiled separately for each color.
 	if (color == Color::RED)
 	{
-		playerPieces = &redPieces;
-		opponentPieces = &blackPieces;
+		return moveGen<Color::RED>(collapseDuplicateCaptures);
 	}
-
 	else
 	{
-		playerPieces = &blackPieces;
-		opponentPieces = &redPieces;
+		return moveGen<Color::BLACK>(collapseDuplicateCaptures);
 	}
+}
+
+template <Color color>
+Board::MoveList Board::moveGen(bool collapseDuplicateCaptures)
+{
+	MoveList totalMoves;
+
+	int bitOffset = 0;
+
+	// Only the pieces that have at least one jump are visited. The mask
+	// holds one bit per square, so walking it lowest bit first keeps the
+	// moves in the same 1 - 32 square order as before.
+	uint32_t jumpingPieces = getJumpingPiecesMask<color>();
 
-	// Go through all 32 squares and see if it is one
-	// of the appropriate pieces belonging to player.
-	for (int pieceIter = 1; pieceIter <= 32; pieceIter++)
+	while (jumpingPieces != 0)
 	{
-		// The offset is used to align to 0 - 31, but
-		// the board in checkers is 1 - 32. Use an offset
-		// here to align to the position bits properly.
-		bitOffset = pieceIter - 1;
+		bitOffset = __builtin_ctz(jumpingPieces);
+		jumpingPieces &= jumpingPieces - 1;
 
-		if ((((playerPieces->pieces) >> bitOffset) & 1) == 1)
-		{
-			// Check for possible jump mpves first.
-			returnedMoves = getJumpsForPiece(color, pieceIter, playerPieces, opponentPieces);
-			totalMoves.insert(totalMoves.end(), returnedMoves.begin(), returnedMoves.end());
-		}
+		// The board in checkers is 1 - 32, so add the offset back.
+		getJumpsForPiece<color>(bitOffset + 1, totalMoves, collapseDuplicateCaptures);
 	}
 
-	// Go through all 32 squares and see if it is one
-	// of the appropriate pieces belonging to player.
-	// Do this only if no jumps are possible. This is controlled
-	// by the if condition here. No need to get moves if there are
+	// Do this only if no jumps are possible. No need to get moves if there are
 	// jumps already found.
 	if (totalMoves.size() == 0)
 	{
-		for (int pieceIter = 1; pieceIter <= 32; pieceIter++)
+		uint32_t movablePieces = getMovablePiecesMask<color>();
+
+		while (movablePieces != 0)
 		{
-			// The offset is used to align to 0 - 31, but
-			// the board in checkers is 1 - 32. Use an offset
-			// here to align to the position bits properly.
-			bitOffset = pieceIter - 1;
+			bitOffset = __builtin_ctz(movablePieces);
+			movablePieces &= movablePieces - 1;
 
-			// Check if player is in this space
-			if ((((playerPieces->pieces) >> bitOffset) & 1) == 1)
-			{
-				// Check for non jump moves here.
-				returnedMoves = getMovesForPiece(color, pieceIter, playerPieces, opponentPieces);
-				totalMoves.insert(totalMoves.end(), returnedMoves.begin(), returnedMoves.end());
-			}
+			getMovesForPiece<color>(bitOffset + 1, totalMoves);
 		}
 	}
 	return totalMoves;
 }
 
 /**
- * Member Function | Board | getJumpsForPiece
- *
- * Summary :	Gets all of the possible jumps for the specific
- *				piece based on the color parameter and location.
- *				This is only called after confirming that the player
- *				has a piece in the proper location.
- *
- * @author : David Torrente
+ * Member Function | Board | getMovablePiecesMask
  *
- * @param Color color :				The player color of pieces to
- *									get the jumps for.
- * 
- * @param int piece	  :				The board location to get the jumps
- *									for.
- * 
- * @param Pieces *playerPieces :	A pointer to the player pieces.
- *									Needed since these can block a possible
- *									jump.
+ * Summary :	Gets every piece of the player that has at least one
+ *				simple (non jump) move. The whole side is handled at
+ *				once by shifting the empty squares back along each
+ *				diagonal the pieces are allowed to travel.
  *
- * @param Pieces *opponentPieces :	A pointer to the opponent pieces.
- *									Needed since these can block a possible
- *									jump as well as to confirm that a jump
- *									can happen.
+ * @param Color color :			The player color to get the pieces for.
  *
- * @return vector<Board::Move> :	A vector of possible jumps
- *									for the particular piece.
+ * @return uint32_t :			A bit field, bit 0 being square 1, of the
+ *								pieces that can move.
  *
  */
-std::vector<Board::Move> Board::getJumpsForPiece(Color color, int piece, Pieces *playerPieces, Pieces *opponentPieces)
+uint32_t Board::getMovablePiecesMask(Color color)
 {
-	// The returned vector of all possible jumps carried out completely
-	std::vector<Move> finalMoves;
-
-	Board board;
-
-	bool wasKingPriorMove = false;
-
 	if (color == Color::RED)
 	{
-		board.redPieces = *playerPieces;
-		board.blackPieces = *opponentPieces;
+		return getMovablePiecesMask<Color::RED>();
 	}
 	else
 	{
-		board.redPieces = *opponentPieces;
-		board.blackPieces = *playerPieces;
+		return getMovablePiecesMask<Color::BLACK>();
 	}
-	// In order to start the recursion, this is needed.
-	Move move;
-	move.startSquare = piece;
-	wasKingPriorMove = board.getPlayerPieces(color).isKing(move.startSquare);
+}
+
+template <Color color>
+uint32_t Board::getMovablePiecesMask()
+{
+	uint32_t playerSquares = getSquaresOf<color>();
+	uint32_t emptySquares = ~(redSquares | blackSquares);
+	uint32_t playerKings = playerSquares & kings;
 
-	getJumpsForPieceRec(color, move, finalMoves, board, wasKingPriorMove);
+	// Red men move "down" the board, black men move "up". Kings go both ways.
+	uint32_t movesDown = (color == Color::RED) ? playerSquares : playerKings;
+	uint32_t movesUp = (color == Color::RED) ? playerKings : playerSquares;
 
-	return finalMoves;
+	return ((stepUpRight(emptySquares) | stepUpLeft(emptySquares)) & movesDown) |
+		   ((stepDownRight(emptySquares) | stepDownLeft(emptySquares)) & movesUp);
 }
 
 /**
- * Member Function | Board | getJumpsForPieceRec
+ * Member Function | Board | getJumpingPiecesMask
  *
- * Summary :	Gets all of the possible jumps in a single jump attempt.
- *				Often called "double" jumping. This creates a full
- *				jump chain. a recursive call.
+ * Summary :	Gets every piece of the player that can start a jump.
+ *				For each diagonal, an opponent piece must sit next to
+ *				the player piece with an empty square behind it. Only
+ *				the first jump of a chain is considered here.
  *
- * @author : David Torrente
- * 
- * @param Color color :			The player color of pieces to
- *								get the jump chain for.
- *
- * @param Move move	  :			A starter move. Contains a starting
- *								space, with an empty destination vector.
- *								when passed in to a recursive call,
- *								this destination vector may contain
- *								moves, signifying that it is in the middle
- *								of a jump chain.
- * 
- * @param vector<Board> & totalMovesAccumulator : Accumulates all possible
- *										jumps at the end of each jump chain. Passed
- *										in by reference and returned to calling 
- *										function.
- * 
- * @param Board board :			The current state of the board, updated for each jump.
- * 
- * @param bool wasKingPriorMove	: A value used to determine if the king was a king prior 
- *								  to this move. Becoming a king stops a jump chain.
+ * @param Color color :			The player color to get the pieces for.
+ *
+ * @return uint32_t :			A bit field, bit 0 being square 1, of the
+ *								pieces that can jump.
  *
  */
-void Board::getJumpsForPieceRec(Color color, Board::Move move, std::vector<Board::Move> &totalMovesAccumulator, Board board, bool wasKingPriorMove)
+uint32_t Board::getJumpingPiecesMask(Color color)
 {
+	if (color == Color::RED)
+	{
+		return getJumpingPiecesMask<Color::RED>();
+	}
+	else
+	{
+		return getJumpingPiecesMask<Color::BLACK>();
+	}
+}
 
-	int piece;
-
-	bool endOfJumpChain = true;
+template <Color color>
+uint32_t Board::getJumpingPiecesMask()
+{
+	uint32_t playerSquares = getSquaresOf<color>();
+	uint32_t opponentSquares = getSquaresOf<getOpponentColor(color)>();
+	uint32_t emptySquares = ~(playerSquares | opponentSquares);
+	uint32_t playerKings = playerSquares & kings;
+
+	uint32_t movesDown = (color == Color::RED) ? playerSquares : playerKings;
+	uint32_t movesUp = (color == Color::RED) ? playerKings : playerSquares;
+
+	return (stepUpRight(stepUpRight(emptySquares) & opponentSquares) & movesDown) |
+		   (stepUpLeft(stepUpLeft(emptySquares) & opponentSquares) & movesDown) |
+		   (stepDownRight(stepDownRight(emptySquares) & opponentSquares) & movesUp) |
+		   (stepDownLeft(stepDownLeft(emptySquares) & opponentSquares) & movesUp);
+}
 
-	bool isKing = false;
+/**
+ * Member Function | Board | hasAnyMove
+ *
+ * Summary :	Checks whether the player has any legal move, jump or
+ *				step, without generating the moves. This is the same as
+ *				moveGen(color).size() != 0, and is what decides a win.
+ *
+ * @param Color color :			The player color to check.
+ *
+ * @return bool :				True if the player can move.
+ *
+ */
+bool Board::hasAnyMove(Color color)
+{
+	// Steps are the common case, so they are checked first. A piece
+	// can be boxed in and still jump, so jumps are checked as well.
+	return getMovablePiecesMask(color) != 0 || getJumpingPiecesMask(color) != 0;
+}
 
-	int bitOffset = 0;
-	int squareJumped = 0;
+/**
+ * Member Function | Board | hasAnyJump
+ *
+ * Summary :	Checks whether the player has a jump available, which
+ *				makes jumping mandatory for this turn.
+ *
+ * @param Color color :			The player color to check.
+ *
+ * @return bool :				True if the player can jump.
+ *
+ */
+bool Board::hasAnyJump(Color color)
+{
+	return getJumpingPiecesMask(color) != 0;
+}
 
-	// This determines if we are starting the jump sequence or in the middle of it.
-	if (move.destinationSquare.size() == 0)
+/**
+ * Member Function | Board | getAttackedMask
+ *
+ * Summary :	Gets every piece of the player that the opponent could
+ *				take with a jump if it were the opponent's turn. Along
+ *				each diagonal, a piece is attacked when an opponent
+ *				piece that may travel that way stands next to it and
+ *				the square past it is empty. This gives the same squares
+ *				as the first piece taken by each of the opponent's jumps,
+ *				with a few shifts per direction and no move list.
+ *
+ * @param Color color :			The player color to get the pieces for.
+ *
+ * @return uint32_t :			A bit field, bit 0 being square 1, of the
+ *								pieces that can be taken.
+ *
+ */
+uint32_t Board::getAttackedMask(Color color) const
+{
+	if (color == Color::RED)
 	{
-		piece = move.startSquare;
-		// use the current board as it is.
+		return getAttackedMask<Color::RED>();
 	}
 	else
 	{
-		piece = move.destinationSquare.back();
-		board = updateBoard(move, color);
+		return getAttackedMask<Color::BLACK>();
 	}
+}
 
-	// First, determine if it is a king. This is needed to see which moves
-	// are valid for this piece/player. Move either up/down at first.
-	isKing = board.getPlayerPieces(color).isKing(piece);
+template <Color color>
+uint32_t Board::getAttackedMask() const
+{
+	uint32_t playerSquares = getPiecesMask(color);
+	uint32_t opponentSquares = getPiecesMask(getOpponentColor(color));
 
-	if (isKing == wasKingPriorMove)
-	{
-		// Check if a jump position is open for this piece. This goes through all of the jumps.
-		for (int jumpIter = 0; jumpIter < Board::boardMoveTable[piece].jumps.size(); jumpIter++)
-		{
-			// Get the position of the jump, reduce it by one for an offset. Note
-			// that while it is one less than the position, the direction check still works
-			// since a jump will always be greater than the distance needed to determine
-			// direction.
-			bitOffset = (Board::boardMoveTable[piece].jumps.at(jumpIter) - 1);
-
-			// Check to see which direction it is going, and if it can go that direction.
-			// King goes both ways		Red not a king goes "down"            Black not a king goes "up"
-			if (isKing || ((piece - bitOffset) < 0 && color == Color::RED) || ((piece - bitOffset) > 0 && color == Color::BLACK))
-			{
-				// Combine both bit fields into one and check if the space is empty.
-				if ((((board.getPlayerPieces(color).pieces | board.getOpponentPieces(color).pieces) >> bitOffset) & 1) == 0)
-				{
-					// If it is open, get the space between. We will need to check it.
-					// Again with the -1 to help with the offset
-					squareJumped = Board::boardMoveTable[piece].removals.at(jumpIter) - 1;
-
-					if (((board.getOpponentPieces(color).pieces >> squareJumped) & 1) == 1)
-					{
-						// Yup, we are good!!!! this means that an opponent was in this spot and
-						// we can jump them.
-
-						// Since we found a new jump, we need to keep going with the jump chain
-						endOfJumpChain = false;
-
-						// Do not change start square. This is set to the overall start of the jump.
-						// Commented out to show the thought process behind setting the move.
-						// move.startSquare = piece;
-
-						move.destinationSquare.push_back(bitOffset + 1);
-						move.removalSquare.push_back(squareJumped + 1);
-
-						//make recursive call here
-						getJumpsForPieceRec(color, move, totalMovesAccumulator, board, wasKingPriorMove);
-						// Remove the jump we just added to the chain. We've already made the recursive call
-						move.destinationSquare.pop_back();
-						move.removalSquare.pop_back();
-					}
-				}
-			}
-		}
-	}
+	return getAttackedAlong<color, UP_LEFT>(playerSquares, opponentSquares) |
+		   getAttackedAlong<color, UP_RIGHT>(playerSquares, opponentSquares) |
+		   getAttackedAlong<color, DOWN_LEFT>(playerSquares, opponentSquares) |
+		   getAttackedAlong<color, DOWN_RIGHT>(playerSquares, opponentSquares);
+}
 
-	if (endOfJumpChain == true)
-	{
-		// Once here, it means we are at the leaf of a jump or
-		// that we became a king due to this jump.
-		// We add it to the list at that point.
-		// It will rise back up the chain when the stack unwinds.
+template <Color color, int direction>
+uint32_t Board::getAttackedAlong(uint32_t playerSquares, uint32_t opponentSquares) const
+{
+	uint32_t emptySquares = ~(playerSquares | opponentSquares);
+	uint32_t attackers = getPiecesMovingToward<getOpponentColor(color)>(opponentSquares, direction);
 
-		if (move.destinationSquare.size() != 0)
-		{
-			totalMovesAccumulator.push_back(move);
-		}
-	}
+	return stepSquares(attackers, direction) & playerSquares & stepSquares(emptySquares, getOppositeDirection(direction));
 }
 
 /**
- * Member Function | Board | getMovesForPiece
+ * Member Function | Board | getHangingMask
  *
- * Summary :	Gets all of the possible moves for a piece. This call knows that the
- *				piece is a proper piece for this color to play on prior to this call.
- *				Also note that prior to this call, jumps should be checked. If there
- *				are jumps, do not allow these moves.
- *
- * @author : David Torrente 
- * 
- * @param Color color :				The player color of pieces to
- *									get the moves for.
- *
- * @param int piece	  :				The board location to get the moves
- *									for.
+ * Summary :	Gets the attacked pieces of the player that would be lost
+ *				for nothing: after the opponent jumps one, no piece of
+ *				the player can jump the opponent piece on its landing
+ *				square. The square of the taken piece is empty by then,
+ *				so a piece behind the landing square can take back along
+ *				the same diagonal. A piece attacked from more than one
+ *				side is hanging if any of the jumps is safe.
  *
- * @param Pieces *playerPieces :	A pointer to the player pieces.
- *									Needed since these can block a possible
- *									jump.
+ *				Only the first hop of a jump is looked at. An attacker
+ *				that can jump on does not stop on the landing square,
+ *				so such a piece may be reported safe when it is not.
  *
- * @param Pieces *opponentPieces :	A pointer to the opponent pieces.
- *									Needed since these can block a possible
- *									jump as well as to confirm that a jump
- *									can happen.
+ * @param Color color :			The player color to get the pieces for.
  *
- * @return vector<Board::Move> :	A vector of possible moves
- *									for the particular piece.
+ * @return uint32_t :			A bit field, bit 0 being square 1, of the
+ *								pieces that can be taken with no reply.
  *
  */
-std::vector<Board::Move> Board::getMovesForPiece(Color color, int piece, Pieces *playerPieces, Pieces *opponentPieces)
+uint32_t Board::getHangingMask(Color color) const
 {
-	std::vector<Move> moves;
-	Move move;
+	if (color == Color::RED)
+	{
+		return getHangingMask<Color::RED>();
+	}
+	else
+	{
+		return getHangingMask<Color::BLACK>();
+	}
+}
 
-	bool isKing = false;
+template <Color color>
+uint32_t Board::getHangingMask() const
+{
+	uint32_t playerSquares = getPiecesMask(color);
+	uint32_t opponentSquares = getPiecesMask(getOpponentColor(color));
 
-	int squareJumped = 0;
+	return getHangingAlong<color, UP_LEFT>(playerSquares, opponentSquares) |
+		   getHangingAlong<color, UP_RIGHT>(playerSquares, opponentSquares) |
+		   getHangingAlong<color, DOWN_LEFT>(playerSquares, opponentSquares) |
+		   getHangingAlong<color, DOWN_RIGHT>(playerSquares, opponentSquares);
+}
 
-	int bitOffset = 0;
+template <Color color, int direction>
+uint32_t Board::getHangingAlong(uint32_t playerSquares, uint32_t opponentSquares) const
+{
+	const int backDirection = getOppositeDirection(direction);
+	uint32_t attackedSquares = getAttackedAlong<color, direction>(playerSquares, opponentSquares);
 
-	// First, determine if it is a king. This is needed to see which moves
-	// are valid for this piece/player. Move either up/down at first.
-	if (playerPieces->isKing(piece))
-	{
-		isKing = true;
-	}
-	else
+	if (attackedSquares == 0)
 	{
-		isKing = false;
+		return 0;
 	}
 
-	for (int moveIter = 0; moveIter < Board::boardMoveTable[piece].moves.size(); moveIter++)
+	uint32_t emptySquares = ~(playerSquares | opponentSquares);
+	uint32_t landingSquares = stepSquares(attackedSquares, direction);
+	uint32_t retakenSquares = 0;
+
+	for (int retakeDirection = UP_LEFT; retakeDirection <= DOWN_RIGHT; retakeDirection++)
 	{
-		bitOffset = Board::boardMoveTable[piece].moves.at(moveIter) - 1;
-		if (isKing || ((piece - bitOffset) < 0 && color == Color::RED) || ((piece - bitOffset) > 0 && color == Color::BLACK))
+		// Coming along the attack the taker would be the taken piece
+		if (retakeDirection == direction)
 		{
-			if ((((playerPieces->pieces | opponentPieces->pieces) >> bitOffset) & 1) == 0)
-			{
-				move.startSquare = piece;
-				move.destinationSquare.push_back(bitOffset + 1);
-				moves.push_back(move);
-				move.destinationSquare.clear();
-			}
+			continue;
 		}
+
+		uint32_t takers = getPiecesMovingToward<color>(playerSquares, retakeDirection);
+		uint32_t freeBeyond = (retakeDirection == backDirection)
+								  ? ~0U
+								  : stepSquares(emptySquares, getOppositeDirection(retakeDirection));
+
+		retakenSquares |= stepSquares(takers, retakeDirection) & landingSquares & freeBeyond;
 	}
 
-	return moves;
+	return stepSquares(landingSquares & ~retakenSquares, backDirection);
 }
 
 /**
- * Member Function | Board | printBoard
+ * Member Function | Board | getPiecesMovingToward
+ *
+ * Summary :	Keeps the squares whose pieces may travel in a direction.
+ *				Kings go every way, red men only down and black men
+ *				only up. The template color owns the pieces.
+ *
+ * @param uint32_t squares :	Pieces of the template color.
+ *
+ * @param int direction :		UP_LEFT, UP_RIGHT, DOWN_LEFT or DOWN_RIGHT.
+ *
+ * @return uint32_t :			The pieces that may step that way.
+ *
+ */
+template <Color color>
+uint32_t Board::getPiecesMovingToward(uint32_t squares, int direction) const
+{
+	bool isForward = (direction == DOWN_LEFT || direction == DOWN_RIGHT) == (color == Color::RED);
+
+	return isForward ? squares : squares & kings;
+}
+
+/**
+ * Member Function | Board | getSquaresOf, getKingRowMask
+ *
+ * Summary :	Gets the squares of the template color, and the row where
+ *				its men are kinged. Red starts on squares 1 - 12 and
+ *				is kinged on 29 - 32, black the other way around. The
+ *				color is a constant, so no branch is left at run time.
+ *
+ */
+template <Color color>
+uint32_t &Board::getSquaresOf()
+{
+	return color == Color::RED ? redSquares : blackSquares;
+}
+
+template <Color color>
+uint32_t Board::getKingRowMask()
+{
+	return color == Color::RED ? RED_KING_ROW_MASK : BLACK_KING_ROW_MASK;
+}
+
+/**
+ * Member Function | Board | getStepTargets
+ *
+ * Summary :	Gets the squares one diagonal step away from a single
+ *				square, limited to the directions the piece may travel.
+ *				The template color is the player that owns the piece.
+ *
+ * @param uint32_t square :		The square as a single bit.
+ *
+ * @param bool isKing :			Kings may step in all four directions.
+ *
+ * @return uint32_t :			The reachable squares, occupied or not.
+ *
+ */
+template <Color color>
+uint32_t Board::getStepTargets(uint32_t square, bool isKing)
+{
+	uint32_t targets = 0;
+
+	if (isKing || color == Color::RED)
+	{
+		targets |= stepDownLeft(square) | stepDownRight(square);
+	}
+
+	if (isKing || color == Color::BLACK)
+	{
+		targets |= stepUpLeft(square) | stepUpRight(square);
+	}
+
+	return targets;
+}
+
+/**
+ * Member Function | Board | getJumpsForPiece
+ *
+ * Summary :	Gets all of the possible jumps for the specific
+ *				piece based on the color parameter and location.
+ *				This is only called after confirming that the player
+ *				has a piece in the proper location. Each jump is
+ *				carried out completely, often called "double" jumping.
+ *
+ *				The chain is walked depth first with an explicit stack,
+ *				one frame per hop, instead of recursing on board copies.
+ *				Jumped pieces come off the board as soon as they are
+ *				taken and the start square is empty once the piece has
+ *				left it, exactly as if each hop had been played.
+ *				Becoming a king stops a jump chain. The template color
+ *				is the player color of pieces to get the jumps for.
+ *
+ *				A king can sometimes take the same pieces by different
+ *				routes, for example around a ring of pieces in either
+ *				direction, and end on the same square. Those routes all
+ *				lead to the same position. A man cannot, since each of
+ *				its hops moves it forward.
+ *
+ * @author : David Torrente
+ *
+ * @param int piece	  :				The board location to get the jumps
+ *									for.
+ *
+ * @param MoveList &finalMoves :	All possible jumps for the particular
+ *									piece, carried out completely, are
+ *									appended here.
+ *
+ * @param bool collapseDuplicateCaptures :	If true, only the first of the
+ *									routes leading to the same position is
+ *									appended.
+ *
+ */
+template <Color color>
+void Board::getJumpsForPiece(int piece, MoveList &finalMoves, bool collapseDuplicateCaptures)
+{
+	// One frame per hop in the chain: the square the piece stands on,
+	// the landing squares still to try from it and the piece jumped to
+	// get there. A chain takes at most 12 pieces.
+	struct JumpFrame
+	{
+		int square;
+		uint32_t landings;
+		uint32_t jumped;
+	};
+
+	JumpFrame chain[SquareList::MAX_SQUARES + 1];
+
+	uint32_t startSquare = 1U << (piece - 1);
+	uint32_t opponentSquares = getSquaresOf<getOpponentColor(color)>();
+	uint32_t emptySquares = ~((getSquaresOf<color>() & ~startSquare) | opponentSquares);
+	uint32_t capturedSquares = 0;
+
+	bool isKing = (kings & startSquare) != 0;
+
+	// The end square and pieces taken of each route appended so far, when
+	// routes to the same position are collapsed.
+	bool checkDuplicates = collapseDuplicateCaptures && isKing;
+	int listedEnds[MoveList::MAX_MOVES];
+	uint32_t listedCaptures[MoveList::MAX_MOVES];
+	int numListed = 0;
+
+	Move move;
+	move.startSquare = piece;
+
+	int depth = 0;
+	chain[0].square = piece;
+	chain[0].landings = getJumpTargets<color>(startSquare, isKing, opponentSquares, emptySquares);
+	chain[0].jumped = 0;
+
+	while (depth >= 0)
+	{
+		if (chain[depth].landings == 0)
+		{
+			// Every jump from this square has been tried. Step back one hop
+			// and put the piece taken on it back on the board.
+			capturedSquares &= ~chain[depth].jumped;
+			emptySquares &= ~chain[depth].jumped;
+
+			if (depth > 0)
+			{
+				move.destinationSquare.pop_back();
+				move.removalSquare.pop_back();
+			}
+
+			depth--;
+			continue;
+		}
+
+		// Landings are tried lowest square first, the same order as the
+		// old move table.
+		int bitOffset = __builtin_ctz(chain[depth].landings);
+		chain[depth].landings &= chain[depth].landings - 1;
+
+		uint32_t landingSquare = 1U << bitOffset;
+
+		// The only square next to both the start and the end of a jump is
+		// the one jumped over.
+		uint32_t jumpedSquare = getStepTargets<color>(1U << (chain[depth].square - 1), true) &
+								getStepTargets<color>(landingSquare, true);
+
+		move.destinationSquare.push_back(bitOffset + 1);
+		move.removalSquare.push_back(__builtin_ctz(jumpedSquare) + 1);
+
+		capturedSquares |= jumpedSquare;
+		emptySquares |= jumpedSquare;
+
+		// Check to see if we've landed in the kinging row. That ends the chain.
+		bool becameKing = !isKing && (landingSquare & getKingRowMask<color>()) != 0;
+
+		uint32_t nextLandings = 0;
+
+		if (!becameKing)
+		{
+			nextLandings = getJumpTargets<color>(landingSquare, isKing, opponentSquares & ~capturedSquares, emptySquares);
+		}
+
+		if (nextLandings == 0)
+		{
+			// Once here, it means we are at the leaf of a jump or
+			// that we became a king due to this jump.
+			bool isDuplicate = false;
+
+			if (checkDuplicates)
+			{
+				for (int listedIter = 0; listedIter < numListed && !isDuplicate; listedIter++)
+				{
+					isDuplicate = listedEnds[listedIter] == bitOffset + 1 && listedCaptures[listedIter] == capturedSquares;
+				}
+
+				if (!isDuplicate && numListed < MoveList::MAX_MOVES)
+				{
+					listedEnds[numListed] = bitOffset + 1;
+					listedCaptures[numListed] = capturedSquares;
+					numListed++;
+				}
+			}
+
+			if (!isDuplicate)
+			{
+				finalMoves.push_back(move);
+			}
+
+			capturedSquares &= ~jumpedSquare;
+			emptySquares &= ~jumpedSquare;
+			move.destinationSquare.pop_back();
+			move.removalSquare.pop_back();
+		}
+		else
+		{
+			depth++;
+			chain[depth].square = bitOffset + 1;
+			chain[depth].landings = nextLandings;
+			chain[depth].jumped = jumpedSquare;
+		}
+	}
+}
+
+/**
+ * Member Function | Board | getJumpTargets
+ *
+ * Summary :	Gets the squares a single piece can land on with one jump.
+ *				An opponent piece must be next to it on a diagonal the
+ *				piece may travel, with an empty square behind. The
+ *				template color is the player that owns the piece.
+ *
+ * @param uint32_t square :			The square as a single bit.
+ *
+ * @param bool isKing :				Kings may jump in all four directions.
+ *
+ * @param uint32_t opponentSquares : The pieces that may be jumped.
+ *
+ * @param uint32_t emptySquares :	The squares that may be landed on.
+ *
+ * @return uint32_t :				The landing squares.
+ *
+ */
+template <Color color>
+uint32_t Board::getJumpTargets(uint32_t square, bool isKing, uint32_t opponentSquares, uint32_t emptySquares)
+{
+	uint32_t targets = 0;
+
+	if (isKing || color == Color::RED)
+	{
+		targets |= stepDownLeft(stepDownLeft(square) & opponentSquares) |
+				   stepDownRight(stepDownRight(square) & opponentSquares);
+	}
+
+	if (isKing || color == Color::BLACK)
+	{
+		targets |= stepUpLeft(stepUpLeft(square) & opponentSquares) |
+				   stepUpRight(stepUpRight(square) & opponentSquares);
+	}
+
+	return targets & emptySquares;
+}
+
+/**
+ * Member Function | Board | getMovesForPiece
+ *
+ * Summary :	Gets all of the possible moves for a piece. This call knows that the
+ *				piece is a proper piece for this color to play on prior to this call.
+ *				Also note that prior to this call, jumps should be checked. If there
+ *				are jumps, do not allow these moves. The template color is
+ *				the player color of pieces to get the moves for.
+ *
+ * @author : David Torrente 
+ * 
+ * @param int piece	  :				The board location to get the moves
+ *									for.
+ *
+ * @param MoveList &moves :		The possible moves for the particular
+ *									piece are appended here.
+ *
+ */
+template <Color color>
+void Board::getMovesForPiece(int piece, MoveList &moves)
+{
+	Move move;
+
+	int bitOffset = 0;
+
+	uint32_t emptySquares = ~(redSquares | blackSquares);
+	uint32_t pieceSquare = 1U << (piece - 1);
+
+	// First, determine if it is a king. This is needed to see which moves
+	// are valid for this piece/player. Move either up/down at first.
+	uint32_t targets = getStepTargets<color>(pieceSquare, (kings & pieceSquare) != 0) & emptySquares;
+
+	move.startSquare = piece;
+
+	while (targets != 0)
+	{
+		bitOffset = __builtin_ctz(targets);
+		targets &= targets - 1;
+
+		move.destinationSquare.push_back(bitOffset + 1);
+		moves.push_back(move);
+		move.destinationSquare.clear();
+	}
+}
+
+/**
+ * Member Function | Board | printBoard
  *
  * Summary :	Prints the current state of the board. It is a constant function.
  *
@@ -560,9 +974,9 @@ void Board::printBoard() const
 
 			squareOffset = (rowIter * 4 + colIter);
 
-			if (((redPieces.pieces >> squareOffset) & 1) == 1)
+			if (((redSquares >> squareOffset) & 1) == 1)
 			{
-				if (redPieces.isKing(squareOffset + 1))
+				if (((kings >> squareOffset) & 1) == 1)
 				{
 					std::cout << Pieces::ANSII_RED_HIGH << " R " << Pieces::ANSII_END << "|";
 				}
@@ -571,9 +985,9 @@ void Board::printBoard() const
 					std::cout << Pieces::ANSII_RED_HIGH << " r " << Pieces::ANSII_END << "|";
 				}
 			}
-			else if (((blackPieces.pieces >> squareOffset) & 1) == 1)
+			else if (((blackSquares >> squareOffset) & 1) == 1)
 			{
-				if (blackPieces.isKing(squareOffset + 1))
+				if (((kings >> squareOffset) & 1) == 1)
 				{
 					std::cout << Pieces::ANSII_BLUE_START << " B " << Pieces::ANSII_END << "|";
 				}
@@ -626,7 +1040,8 @@ void Board::printBoard() const
  * Summary :	Gets the type of piece at a particular location for a particular color.
  *				Note that the position does not need to be checked for a piece prior to this
  *				call. If the position does not contain a piece of the matching color type, 
- *				it will report as empty for that color.
+ *				it will report as empty for that color. Positions off the board, such as 0,
+ *				also report as empty.
  *
  * @author : David Torrente 
  * 
@@ -643,22 +1058,18 @@ void Board::printBoard() const
 int Board::getPieceInSquare(int position, Color color)
 {
 	int pieceType = 0;
-	Pieces playerPieces;
+	uint32_t playerSquares = getPiecesMask(color);
 
-	if (Color::RED == color)
+	if (position < 1 || position > 32)
 	{
-		playerPieces = redPieces;
-	}
-	else
-	{
-		playerPieces = blackPieces;
+		return pieceType;
 	}
 
-	if (((playerPieces.pieces >> (position - 1)) & 1) == 1)
+	if (((playerSquares >> (position - 1)) & 1) == 1)
 	{
 		pieceType = 1;
 
-		if (playerPieces.isKing(position))
+		if (((kings >> (position - 1)) & 1) == 1)
 		{
 			pieceType = 2;
 		}
@@ -673,7 +1084,7 @@ int Board::getPieceInSquare(int position, Color color)
  * Summary :	Updates the entire board based on a given move. Note that this updates the complete
  *				board for both sides. This will always operate on a single properly formatted move.
  *				It will also convert pieces into kings if they reach the back row of the opposing 
- *				player.
+ *				player. The current board is left as it is; see makeMove to change it in place.
  *
  * @author : David Torrente 
  * 
@@ -684,360 +1095,753 @@ int Board::getPieceInSquare(int position, Color color)
  *									to determine if a piece needs to be kinged.
  *
  * @return Board	:				Returns a new copy of the board. Note that this is only 
- *									two bitfields (small).
+ *									three bitfields and the side to move (small).
  *
  */
 Board Board::updateBoard(Move move, Color color)
 {
+	Board updatedBoard = *this;
+	Undo undo;
 
-	Board updatedBoard;
-	updatedBoard.blackPieces = blackPieces;
-	updatedBoard.redPieces = redPieces;
+	updatedBoard.makeMove(move, color, undo);
 
-	Pieces *playerPieces;
-	Pieces *opponentPieces;
+	return updatedBoard;
+}
+
+/**
+ * Member Function | Board | makeMove
+ *
+ * Summary :	Applies a move to this board in place. Moves the piece, removes
+ *				every jumped piece and kings the piece if it lands on the back
+ *				row of the opposing player. What is needed to take the move back
+ *				is written to the undo record. Only the start square, the end
+ *				square and the pieces taken matter, so a move may be given
+ *				either in full or packed.
+ *
+ * @param Move move	  :				The move to apply to the board. Includes the destination 
+ *									and pieces to remove.
+ *
+ * @param Color color :				The player color that is applying this move.
+ *
+ * @param Undo &undo  :				Receives the captured pieces and whether the
+ *									piece was kinged by this move.
+ *
+ */
+void Board::makeMove(const Move &move, Color color, Undo &undo)
+{
+	makeMove(packMove(move), color, undo);
+}
 
+void Board::makeMove(PackedMove move, Color color, Undo &undo)
+{
 	if (color == Color::RED)
 	{
-		playerPieces = &updatedBoard.redPieces;
-		opponentPieces = &updatedBoard.blackPieces;
+		makeMove<Color::RED>(move, undo);
 	}
 	else
 	{
-		playerPieces = &updatedBoard.blackPieces;
-		opponentPieces = &updatedBoard.redPieces;
+		makeMove<Color::BLACK>(move, undo);
+	}
+}
+
+template <Color color>
+void Board::makeMove(PackedMove move, Undo &undo)
+{
+	const int colorIndex = (color == Color::RED) ? 0 : 1;
+	uint32_t startSquare = 1U << (move.getStartSquare() - 1);
+	uint32_t endSquare = 1U << (move.getEndSquare() - 1);
+	bool wasKing = (kings & startSquare) != 0;
+
+	undo.hashKey = hashKey;
+
+	// Lift the piece from the start square first. A king may finish a jump
+	// chain on the square it started from.
+	getSquaresOf<color>() = (getSquaresOf<color>() & ~startSquare) | endSquare;
+	kings &= ~startSquare;
+
+	// Check to see if we've landed in the kinging row, the back row opposite the starting side.
+	undo.wasPromoted = !wasKing && (endSquare & getKingRowMask<color>()) != 0;
+
+	if (wasKing || undo.wasPromoted)
+	{
+		kings |= endSquare;
+	}
+
+	hashKey ^= wasKing ? zobristKeys[move.getStartSquare()].kings[colorIndex] : zobristKeys[move.getStartSquare()].men[colorIndex];
+	hashKey ^= (wasKing || undo.wasPromoted) ? zobristKeys[move.getEndSquare()].kings[colorIndex]
+											 : zobristKeys[move.getEndSquare()].men[colorIndex];
+
+	// Remove all jumped spots and set them back to not a king, remembering
+	// which of them were kings.
+	undo.capturedSquares = move.getCapturedSquares();
+	undo.capturedKings = undo.capturedSquares & kings;
+
+	getSquaresOf<getOpponentColor(color)>() &= ~undo.capturedSquares;
+	kings &= ~undo.capturedSquares;
+
+	for (uint32_t captured = undo.capturedSquares; captured != 0; captured &= captured - 1)
+	{
+		int square = __builtin_ctz(captured) + 1;
+
+		hashKey ^= (undo.capturedKings & (1U << (square - 1))) ? zobristKeys[square].kings[1 - colorIndex]
+															   : zobristKeys[square].men[1 - colorIndex];
 	}
 
-	// Position in final destination spot - probably check if it needs to be kinged here.
-	// Do this first since you will need to clear the king flag.
-	playerPieces->pieces = playerPieces->pieces | (1LL << (move.destinationSquare.back() - 1));
-	if (playerPieces->isKing(move.startSquare))
+	hashKey ^= zobristRedToMove;
+	sideToMove = getOpponentColor(color);
+
+	assert(hashKey == computeHashKey());
+}
+
+/**
+ * Member Function | Board | unmakeMove
+ *
+ * Summary :	Takes back a move applied by makeMove, leaving the board exactly
+ *				as it was before. Moves must be taken back in the reverse order
+ *				they were made.
+ *
+ * @param Move move	  :				The move that was applied.
+ *
+ * @param Color color :				The player color that applied the move.
+ *
+ * @param Undo &undo  :				The record filled in when the move was made.
+ *
+ */
+void Board::unmakeMove(const Move &move, Color color, const Undo &undo)
+{
+	unmakeMove(packMove(move), color, undo);
+}
+
+void Board::unmakeMove(PackedMove move, Color color, const Undo &undo)
+{
+	if (color == Color::RED)
 	{
-		playerPieces->setKing(move.startSquare, false);
-		playerPieces->setKing(move.destinationSquare.back(), true);
+		unmakeMove<Color::RED>(move, undo);
 	}
 	else
 	{
-		// Check to see if we've landed in the kinging row, the back row opposite the starting side.
-		if (color == Color::RED && (move.destinationSquare.back() >= 29) || (color == Color::BLACK && (move.destinationSquare.back() <= 4)))
+		unmakeMove<Color::BLACK>(move, undo);
+	}
+}
+
+template <Color color>
+void Board::unmakeMove(PackedMove move, const Undo &undo)
+{
+	uint32_t startSquare = 1U << (move.getStartSquare() - 1);
+	uint32_t endSquare = 1U << (move.getEndSquare() - 1);
+	bool wasKing = (kings & endSquare) != 0 && !undo.wasPromoted;
+
+	getSquaresOf<color>() = (getSquaresOf<color>() & ~endSquare) | startSquare;
+	kings &= ~endSquare;
+
+	if (wasKing)
+	{
+		kings |= startSquare;
+	}
+
+	// Put the jumped pieces back, kings included.
+	getSquaresOf<getOpponentColor(color)>() |= undo.capturedSquares;
+	kings |= undo.capturedKings;
+
+	hashKey = undo.hashKey;
+
+	sideToMove = color;
+}
+
+/**
+ * Member Function | Board | packMove
+ *
+ * Summary :	Packs a move into 32 bits, keeping its start square, end
+ *				square and the pieces it takes.
+ *
+ * @param Move move	  :				The move to pack.
+ *
+ * @return PackedMove :				The packed move.
+ *
+ */
+Board::PackedMove Board::packMove(const Move &move)
+{
+	uint32_t capturedSquares = 0;
+
+	for (int jumpedSpaceIter = 0; jumpedSpaceIter < move.removalSquare.size(); jumpedSpaceIter++)
+	{
+		capturedSquares |= 1U << (move.removalSquare.at(jumpedSpaceIter) - 1);
+	}
+
+	return PackedMove(move.startSquare, move.destinationSquare.back(), capturedSquares);
+}
+
+/**
+ * Member Function | Board | unpackMove
+ *
+ * Summary :	Turns a packed move back into a full move, with every square
+ *				landed on and every piece taken in the order of the jumps.
+ *				This board must be the position the move is played from.
+ *				The moves of the piece are generated and the first one with
+ *				the same start, end and captures is returned, so the result
+ *				is the same move moveGen lists.
+ *
+ * @param PackedMove move :			The packed move.
+ *
+ * @param Color color :				The player color making the move.
+ *
+ * @return Move :					The full move. If the move is not legal here,
+ *									it has no destination squares.
+ *
+ */
+Board::Move Board::unpackMove(PackedMove move, Color color)
+{
+	MoveList pieceMoves;
+	Move unpackedMove;
+	unpackedMove.startSquare = move.getStartSquare();
+
+	if (!isLegal(move, color))
+	{
+		return unpackedMove;
+	}
+
+	if (color == Color::RED)
+	{
+		if (move.isCapture())
+			getJumpsForPiece<Color::RED>(move.getStartSquare(), pieceMoves);
+		else
+			getMovesForPiece<Color::RED>(move.getStartSquare(), pieceMoves);
+	}
+	else
+	{
+		if (move.isCapture())
+			getJumpsForPiece<Color::BLACK>(move.getStartSquare(), pieceMoves);
+		else
+			getMovesForPiece<Color::BLACK>(move.getStartSquare(), pieceMoves);
+	}
+
+	for (int moveIter = 0; moveIter < pieceMoves.size(); moveIter++)
+	{
+		if (packMove(pieceMoves.at(moveIter)) == move)
 		{
-			playerPieces->setKing(move.destinationSquare.back(), true);
+			return pieceMoves.at(moveIter);
 		}
 	}
 
-	// Remove start pos
-	if (move.startSquare != move.destinationSquare.back())
+	return unpackedMove;
+}
+
+/**
+ * Member Function | Board | isLegal
+ *
+ * Summary :	Checks whether a packed move is one of the moves moveGen
+ *				gives the player here, without generating them. A step
+ *				must go to an empty square the piece may step to, and
+ *				no piece of the player may have a jump. A jump must take
+ *				opponent pieces only, and there must be a route of hops
+ *				from the start square that takes exactly those pieces,
+ *				ends on the end square and cannot go on from there.
+ *
+ * @param PackedMove move :			The move to check, from any source.
+ *
+ * @param Color color :				The player color making the move.
+ *
+ * @return bool :					True if the move may be played here.
+ *
+ */
+bool Board::isLegal(PackedMove move, Color color)
+{
+	if (color == Color::RED)
 	{
-		playerPieces->pieces = playerPieces->pieces & ~(1LL << (move.startSquare - 1));
+		return isLegal<Color::RED>(move);
 	}
+	else
+	{
+		return isLegal<Color::BLACK>(move);
+	}
+}
 
-	// Remove all jumped spots and set them back to not a king.
-	for (int jumpedSpaceIter = 0; jumpedSpaceIter < move.removalSquare.size(); jumpedSpaceIter++)
+template <Color color>
+bool Board::isLegal(PackedMove move)
+{
+	uint32_t startSquare = 1U << (move.getStartSquare() - 1);
+	uint32_t endSquare = 1U << (move.getEndSquare() - 1);
+	uint32_t opponentSquares = getSquaresOf<getOpponentColor(color)>();
+
+	if (move.isNull() || (getSquaresOf<color>() & startSquare) == 0)
 	{
-		opponentPieces->pieces = opponentPieces->pieces & ~(1LL << (move.removalSquare.at(jumpedSpaceIter) - 1));
-		opponentPieces->pieces = opponentPieces->pieces & ~(1LL << (move.removalSquare.at(jumpedSpaceIter) + 31));
+		return false;
 	}
 
-	return updatedBoard;
+	// The piece has left its start square, so a king may end a jump there
+	uint32_t emptySquares = ~((getSquaresOf<color>() & ~startSquare) | opponentSquares);
+	bool isKing = (kings & startSquare) != 0;
+
+	if (!move.isCapture())
+	{
+		return (getStepTargets<color>(startSquare, isKing) & emptySquares & endSquare) != 0 &&
+			   getJumpingPiecesMask<color>() == 0;
+	}
+
+	uint32_t capturedSquares = move.getCapturedSquares();
+
+	if ((capturedSquares & ~opponentSquares) != 0)
+	{
+		return false;
+	}
+
+	return hasJumpRoute<color>(startSquare, isKing, capturedSquares, endSquare, opponentSquares, emptySquares);
 }
 
 /**
- * Member Function | Board | InitializeMoveTable
+ * Member Function | Board | hasJumpRoute
  *
- * Summary :	Sets up the static move table which is shared among all
- *				boards. Note that it is a move table, not a piece tracker.
- *				pieces are stored in the board. In order to prevent adding 
- *				moves each time a constructor is called, the move table
- *				will not add any additional values after it is set up 
- *				the first time.
+ * Summary :	Looks for the rest of a jump chain, the same way
+ *				getJumpsForPiece walks it, but only over the pieces the
+ *				move takes. Each hop takes one of them, so the search is
+ *				at most one hop deep per piece and almost always has a
+ *				single route to follow.
+ *
+ * @param uint32_t square :			Where the piece stands, as a single bit.
+ *
+ * @param bool isKing :				Whether the piece was a king at the start.
+ *
+ * @param uint32_t capturedSquares : The pieces the move still has to take.
+ *
+ * @param uint32_t endSquare :		Where the move ends, as a single bit.
+ *
+ * @param uint32_t opponentSquares : Opponent pieces not taken so far.
+ *
+ * @param uint32_t emptySquares :	Squares the piece may land on.
+ *
+ * @return bool :					True if such a route exists.
+ *
+ */
+template <Color color>
+bool Board::hasJumpRoute(uint32_t square, bool isKing, uint32_t capturedSquares, uint32_t endSquare,
+						 uint32_t opponentSquares, uint32_t emptySquares)
+{
+	if (capturedSquares == 0)
+	{
+		// A chain goes on as long as it can, so it must end here
+		return square == endSquare && getJumpTargets<color>(square, isKing, opponentSquares, emptySquares) == 0;
+	}
+
+	for (uint32_t landings = getJumpTargets<color>(square, isKing, capturedSquares, emptySquares); landings != 0;
+		 landings &= landings - 1)
+	{
+		uint32_t landingSquare = landings & (0U - landings);
+		uint32_t jumpedSquare = getStepTargets<color>(square, true) & getStepTargets<color>(landingSquare, true);
+
+		// Becoming a king ends the chain
+		if (!isKing && (landingSquare & getKingRowMask<color>()) != 0)
+		{
+			if (capturedSquares == jumpedSquare && landingSquare == endSquare)
+			{
+				return true;
+			}
+
+			continue;
+		}
+
+		if (hasJumpRoute<color>(landingSquare, isKing, capturedSquares & ~jumpedSquare, endSquare,
+								opponentSquares & ~jumpedSquare, emptySquares | jumpedSquare))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * Member Function | Board | getSideToMove
+ *
+ * Summary :	Gets the player whose turn it is on this board.
+ *
+ * @return Color :					The player to move.
+ *
+ */
+Color Board::getSideToMove() const
+{
+	return sideToMove;
+}
+
+/**
+ * Member Function | Board | getHashKey, computeHashKey
+ *
+ * Summary :	Get the 64 bit Zobrist key of the position: the XOR of the
+ *				key of every piece on its square, and of the side key when
+ *				red is to move. getHashKey returns the key makeMove and
+ *				unmakeMove keep up to date with a few XORs per move.
+ *				computeHashKey works the same key out from scratch; debug
+ *				builds check the two agree after every makeMove.
+ *
+ * @return uint64_t :				The hash key.
+ *
+ */
+uint64_t Board::getHashKey() const
+{
+	return hashKey;
+}
+
+uint64_t Board::computeHashKey() const
+{
+	uint64_t key = (sideToMove == Color::RED) ? zobristRedToMove : 0;
+
+	for (uint32_t squares = redSquares | blackSquares; squares != 0; squares &= squares - 1)
+	{
+		int square = __builtin_ctz(squares) + 1;
+		uint32_t squareBit = 1U << (square - 1);
+		int colorIndex = (redSquares & squareBit) ? 0 : 1;
+
+		key ^= (kings & squareBit) ? zobristKeys[square].kings[colorIndex] : zobristKeys[square].men[colorIndex];
+	}
+
+	return key;
+}
+
+/**
+ * Member Function | Board | getFlippedBoard
+ *
+ * Summary :	Gets the same position seen from the other side: the colors
+ *				are swapped and the board is turned half way around, so
+ *				square s becomes square 33 - s and the other player is to
+ *				move. Red and black move in opposite directions, so the
+ *				flipped position plays exactly like this one and has the
+ *				same value for the player to move.
+ *
+ * @return Board :					The flipped position.
+ *
+ */
+Board Board::getFlippedBoard() const
+{
+	Board flippedBoard;
+
+	flippedBoard.redSquares = reverseSquares(blackSquares);
+	flippedBoard.blackSquares = reverseSquares(redSquares);
+	flippedBoard.kings = reverseSquares(kings);
+	flippedBoard.sideToMove = getOpponentColor(sideToMove);
+	flippedBoard.hashKey = swapKeyHalves(hashKey ^ (sideToMove == Color::RED ? zobristRedToMove : 0)) ^
+						   (flippedBoard.sideToMove == Color::RED ? zobristRedToMove : 0);
+
+	return flippedBoard;
+}
+
+/**
+ * Member Function | Board | getCanonicalBoard, getCanonicalHashKey
+ *
+ * Summary :	Get one form shared by a position and its flipped version,
+ *				the one with black to move. A cache keyed on the canonical
+ *				key stores a position and its flip as one entry. Values for
+ *				the player to move carry over as they are, and moves found
+ *				for a flipped board are turned back with flipMove.
+ *
+ *				The canonical key takes no work beyond a half swap: every
+ *				piece key of a flipped board is the matching key of this
+ *				board with its halves swapped.
+ *
+ * @param bool &isFlipped :			Returns true if the position was flipped,
+ *									which is when red is to move.
+ *
+ * @return Board / uint64_t :		The canonical position, or its hash key.
  *
- * @author : David Torrente 
- * 
  */
-void Board::InitializeMoveTable()
+Board Board::getCanonicalBoard(bool &isFlipped) const
+{
+	isFlipped = (sideToMove == Color::RED);
+
+	return isFlipped ? getFlippedBoard() : *this;
+}
+
+uint64_t Board::getCanonicalHashKey(bool &isFlipped) const
 {
+	isFlipped = (sideToMove == Color::RED);
 
-	// In order to support faster look up,
-	// The index of the position is used as
-	// the initial key to an index. Each
-	// position has only a few moves,
-	// even less if there is a mandatory jump.
-	// The table is big, but never changes.
+	return isFlipped ? swapKeyHalves(hashKey ^ zobristRedToMove) : hashKey;
+}
 
-	if (boardMoveTable[1].jumps.size() == 0)
+/**
+ * Member Function | Board | flipMove
+ *
+ * Summary :	Turns a move around the same way getFlippedBoard turns the
+ *				board, so a move of the flipped position becomes the move of
+ *				the original one and the other way around.
+ *
+ * @param PackedMove move :			The move to flip.
+ *
+ * @return PackedMove :				The flipped move.
+ *
+ */
+Board::PackedMove Board::flipMove(PackedMove move)
+{
+	if (move.isNull())
 	{
-		boardMoveTable[1].jumps.push_back(10);
-		boardMoveTable[1].removals.push_back(6);
-		boardMoveTable[1].moves.push_back(5);
-		boardMoveTable[1].moves.push_back(6);
-
-		boardMoveTable[2].jumps.push_back(9);
-		boardMoveTable[2].removals.push_back(6);
-		boardMoveTable[2].jumps.push_back(11);
-		boardMoveTable[2].removals.push_back(7);
-		boardMoveTable[2].moves.push_back(6);
-		boardMoveTable[2].moves.push_back(7);
-
-		boardMoveTable[3].jumps.push_back(10);
-		boardMoveTable[3].removals.push_back(7);
-		boardMoveTable[3].jumps.push_back(12);
-		boardMoveTable[3].removals.push_back(8);
-		boardMoveTable[3].moves.push_back(7);
-		boardMoveTable[3].moves.push_back(8);
-
-		boardMoveTable[4].jumps.push_back(11);
-		boardMoveTable[4].removals.push_back(8);
-		boardMoveTable[4].moves.push_back(8);
-
-		boardMoveTable[5].jumps.push_back(14);
-		boardMoveTable[5].removals.push_back(9);
-		boardMoveTable[5].moves.push_back(1);
-		boardMoveTable[5].moves.push_back(9);
-
-		boardMoveTable[6].jumps.push_back(13);
-		boardMoveTable[6].removals.push_back(9);
-		boardMoveTable[6].jumps.push_back(15);
-		boardMoveTable[6].removals.push_back(10);
-		boardMoveTable[6].moves.push_back(1);
-		boardMoveTable[6].moves.push_back(2);
-		boardMoveTable[6].moves.push_back(9);
-		boardMoveTable[6].moves.push_back(10);
-
-		boardMoveTable[7].jumps.push_back(14);
-		boardMoveTable[7].removals.push_back(10);
-		boardMoveTable[7].jumps.push_back(16);
-		boardMoveTable[7].removals.push_back(11);
-		boardMoveTable[7].moves.push_back(2);
-		boardMoveTable[7].moves.push_back(3);
-		boardMoveTable[7].moves.push_back(10);
-		boardMoveTable[7].moves.push_back(11);
-
-		boardMoveTable[8].jumps.push_back(15);
-		boardMoveTable[8].removals.push_back(11);
-		boardMoveTable[8].moves.push_back(3);
-		boardMoveTable[8].moves.push_back(4);
-		boardMoveTable[8].moves.push_back(11);
-		boardMoveTable[8].moves.push_back(12);
-
-		boardMoveTable[9].jumps.push_back(2);
-		boardMoveTable[9].removals.push_back(6);
-		boardMoveTable[9].jumps.push_back(18);
-		boardMoveTable[9].removals.push_back(14);
-		boardMoveTable[9].moves.push_back(5);
-		boardMoveTable[9].moves.push_back(6);
-		boardMoveTable[9].moves.push_back(13);
-		boardMoveTable[9].moves.push_back(14);
-
-		boardMoveTable[10].jumps.push_back(1);
-		boardMoveTable[10].removals.push_back(6);
-		boardMoveTable[10].jumps.push_back(3);
-		boardMoveTable[10].removals.push_back(7);
-		boardMoveTable[10].jumps.push_back(17);
-		boardMoveTable[10].removals.push_back(14);
-		boardMoveTable[10].jumps.push_back(19);
-		boardMoveTable[10].removals.push_back(15);
-		boardMoveTable[10].moves.push_back(6);
-		boardMoveTable[10].moves.push_back(7);
-		boardMoveTable[10].moves.push_back(14);
-		boardMoveTable[10].moves.push_back(15);
-
-		boardMoveTable[11].jumps.push_back(2);
-		boardMoveTable[11].removals.push_back(7);
-		boardMoveTable[11].jumps.push_back(4);
-		boardMoveTable[11].removals.push_back(8);
-		boardMoveTable[11].jumps.push_back(18);
-		boardMoveTable[11].removals.push_back(15);
-		boardMoveTable[11].jumps.push_back(20);
-		boardMoveTable[11].removals.push_back(16);
-		boardMoveTable[11].moves.push_back(7);
-		boardMoveTable[11].moves.push_back(8);
-		boardMoveTable[11].moves.push_back(15);
-		boardMoveTable[11].moves.push_back(16);
-
-		boardMoveTable[12].jumps.push_back(3);
-		boardMoveTable[12].removals.push_back(8);
-		boardMoveTable[12].jumps.push_back(19);
-		boardMoveTable[12].removals.push_back(16);
-		boardMoveTable[12].moves.push_back(8);
-		boardMoveTable[12].moves.push_back(16);
-
-		boardMoveTable[13].jumps.push_back(6);
-		boardMoveTable[13].removals.push_back(9);
-		boardMoveTable[13].jumps.push_back(22);
-		boardMoveTable[13].removals.push_back(17);
-		boardMoveTable[13].moves.push_back(9);
-		boardMoveTable[13].moves.push_back(17);
-
-		boardMoveTable[14].jumps.push_back(5);
-		boardMoveTable[14].removals.push_back(9);
-		boardMoveTable[14].jumps.push_back(7);
-		boardMoveTable[14].removals.push_back(10);
-		boardMoveTable[14].jumps.push_back(21);
-		boardMoveTable[14].removals.push_back(17);
-		boardMoveTable[14].jumps.push_back(23);
-		boardMoveTable[14].removals.push_back(18);
-		boardMoveTable[14].moves.push_back(9);
-		boardMoveTable[14].moves.push_back(10);
-		boardMoveTable[14].moves.push_back(17);
-		boardMoveTable[14].moves.push_back(18);
-
-		boardMoveTable[15].jumps.push_back(6);
-		boardMoveTable[15].removals.push_back(10);
-		boardMoveTable[15].jumps.push_back(8);
-		boardMoveTable[15].removals.push_back(11);
-		boardMoveTable[15].jumps.push_back(22);
-		boardMoveTable[15].removals.push_back(18);
-		boardMoveTable[15].jumps.push_back(24);
-		boardMoveTable[15].removals.push_back(19);
-		boardMoveTable[15].moves.push_back(10);
-		boardMoveTable[15].moves.push_back(11);
-		boardMoveTable[15].moves.push_back(18);
-		boardMoveTable[15].moves.push_back(19);
-
-		boardMoveTable[16].jumps.push_back(7);
-		boardMoveTable[16].removals.push_back(11);
-		boardMoveTable[16].jumps.push_back(23);
-		boardMoveTable[16].removals.push_back(19);
-		boardMoveTable[16].moves.push_back(11);
-		boardMoveTable[16].moves.push_back(12);
-		boardMoveTable[16].moves.push_back(19);
-		boardMoveTable[16].moves.push_back(20);
-
-		boardMoveTable[17].jumps.push_back(10);
-		boardMoveTable[17].removals.push_back(14);
-		boardMoveTable[17].jumps.push_back(26);
-		boardMoveTable[17].removals.push_back(22);
-		boardMoveTable[17].moves.push_back(13);
-		boardMoveTable[17].moves.push_back(14);
-		boardMoveTable[17].moves.push_back(21);
-		boardMoveTable[17].moves.push_back(22);
-
-		boardMoveTable[18].jumps.push_back(9);
-		boardMoveTable[18].removals.push_back(14);
-		boardMoveTable[18].jumps.push_back(11);
-		boardMoveTable[18].removals.push_back(15);
-		boardMoveTable[18].jumps.push_back(25);
-		boardMoveTable[18].removals.push_back(22);
-		boardMoveTable[18].jumps.push_back(27);
-		boardMoveTable[18].removals.push_back(23);
-		boardMoveTable[18].moves.push_back(14);
-		boardMoveTable[18].moves.push_back(15);
-		boardMoveTable[18].moves.push_back(22);
-		boardMoveTable[18].moves.push_back(23);
-
-		boardMoveTable[19].jumps.push_back(10);
-		boardMoveTable[19].removals.push_back(15);
-		boardMoveTable[19].jumps.push_back(12);
-		boardMoveTable[19].removals.push_back(16);
-		boardMoveTable[19].jumps.push_back(26);
-		boardMoveTable[19].removals.push_back(23);
-		boardMoveTable[19].jumps.push_back(28);
-		boardMoveTable[19].removals.push_back(24);
-		boardMoveTable[19].moves.push_back(15);
-		boardMoveTable[19].moves.push_back(16);
-		boardMoveTable[19].moves.push_back(23);
-		boardMoveTable[19].moves.push_back(24);
-
-		boardMoveTable[20].jumps.push_back(11);
-		boardMoveTable[20].removals.push_back(16);
-		boardMoveTable[20].jumps.push_back(27);
-		boardMoveTable[20].removals.push_back(24);
-		boardMoveTable[20].moves.push_back(16);
-		boardMoveTable[20].moves.push_back(24);
-
-		boardMoveTable[21].jumps.push_back(14);
-		boardMoveTable[21].removals.push_back(17);
-		boardMoveTable[21].jumps.push_back(30);
-		boardMoveTable[21].removals.push_back(25);
-		boardMoveTable[21].moves.push_back(17);
-		boardMoveTable[21].moves.push_back(25);
-
-		boardMoveTable[22].jumps.push_back(13);
-		boardMoveTable[22].removals.push_back(17);
-		boardMoveTable[22].jumps.push_back(15);
-		boardMoveTable[22].removals.push_back(18);
-		boardMoveTable[22].jumps.push_back(29);
-		boardMoveTable[22].removals.push_back(25);
-		boardMoveTable[22].jumps.push_back(31);
-		boardMoveTable[22].removals.push_back(26);
-		boardMoveTable[22].moves.push_back(17);
-		boardMoveTable[22].moves.push_back(18);
-		boardMoveTable[22].moves.push_back(25);
-		boardMoveTable[22].moves.push_back(26);
-
-		boardMoveTable[23].jumps.push_back(14);
-		boardMoveTable[23].removals.push_back(18);
-		boardMoveTable[23].jumps.push_back(16);
-		boardMoveTable[23].removals.push_back(19);
-		boardMoveTable[23].jumps.push_back(30);
-		boardMoveTable[23].removals.push_back(26);
-		boardMoveTable[23].jumps.push_back(32);
-		boardMoveTable[23].removals.push_back(27);
-		boardMoveTable[23].moves.push_back(18);
-		boardMoveTable[23].moves.push_back(19);
-		boardMoveTable[23].moves.push_back(26);
-		boardMoveTable[23].moves.push_back(27);
-
-		boardMoveTable[24].jumps.push_back(15);
-		boardMoveTable[24].removals.push_back(19);
-		boardMoveTable[24].jumps.push_back(31);
-		boardMoveTable[24].removals.push_back(27);
-		boardMoveTable[24].moves.push_back(19);
-		boardMoveTable[24].moves.push_back(20);
-		boardMoveTable[24].moves.push_back(27);
-		boardMoveTable[24].moves.push_back(28);
-
-		boardMoveTable[25].jumps.push_back(18);
-		boardMoveTable[25].removals.push_back(22);
-		boardMoveTable[25].moves.push_back(21);
-		boardMoveTable[25].moves.push_back(22);
-		boardMoveTable[25].moves.push_back(29);
-		boardMoveTable[25].moves.push_back(30);
-
-		boardMoveTable[26].jumps.push_back(17);
-		boardMoveTable[26].removals.push_back(22);
-		boardMoveTable[26].jumps.push_back(19);
-		boardMoveTable[26].removals.push_back(23);
-		boardMoveTable[26].moves.push_back(22);
-		boardMoveTable[26].moves.push_back(23);
-		boardMoveTable[26].moves.push_back(30);
-		boardMoveTable[26].moves.push_back(31);
-
-		boardMoveTable[27].jumps.push_back(18);
-		boardMoveTable[27].removals.push_back(23);
-		boardMoveTable[27].jumps.push_back(20);
-		boardMoveTable[27].removals.push_back(24);
-		boardMoveTable[27].moves.push_back(23);
-		boardMoveTable[27].moves.push_back(24);
-		boardMoveTable[27].moves.push_back(31);
-		boardMoveTable[27].moves.push_back(32);
-
-		boardMoveTable[28].jumps.push_back(19);
-		boardMoveTable[28].removals.push_back(24);
-		boardMoveTable[28].moves.push_back(24);
-		boardMoveTable[28].moves.push_back(32);
-
-		boardMoveTable[29].jumps.push_back(22);
-		boardMoveTable[29].removals.push_back(25);
-		boardMoveTable[29].moves.push_back(25);
-
-		boardMoveTable[30].jumps.push_back(21);
-		boardMoveTable[30].removals.push_back(25);
-		boardMoveTable[30].jumps.push_back(23);
-		boardMoveTable[30].removals.push_back(26);
-		boardMoveTable[30].moves.push_back(25);
-		boardMoveTable[30].moves.push_back(26);
-
-		boardMoveTable[31].jumps.push_back(22);
-		boardMoveTable[31].removals.push_back(26);
-		boardMoveTable[31].jumps.push_back(24);
-		boardMoveTable[31].removals.push_back(27);
-		boardMoveTable[31].moves.push_back(26);
-		boardMoveTable[31].moves.push_back(27);
-
-		boardMoveTable[32].jumps.push_back(23);
-		boardMoveTable[32].removals.push_back(27);
-		boardMoveTable[32].moves.push_back(27);
-		boardMoveTable[32].moves.push_back(28);
+		return move;
 	}
-}
\ No newline at end of file
+
+	return PackedMove(33 - move.getStartSquare(), 33 - move.getEndSquare(), reverseSquares(move.getCapturedSquares()));
+}
+
+/**
+ * Member Function | Board | reverseSquares
+ *
+ * Summary :	Reverses the bits of a 32 bit field, which moves the piece
+ *				on square s to square 33 - s.
+ *
+ * @param uint32_t squares :		The squares to reverse.
+ *
+ * @return uint32_t :				The reversed squares.
+ *
+ */
+uint32_t Board::reverseSquares(uint32_t squares)
+{
+	squares = ((squares >> 1) & 0x55555555) | ((squares & 0x55555555) << 1);
+	squares = ((squares >> 2) & 0x33333333) | ((squares & 0x33333333) << 2);
+	squares = ((squares >> 4) & 0x0F0F0F0F) | ((squares & 0x0F0F0F0F) << 4);
+
+	return __builtin_bswap32(squares);
+}
+
+/**
+ * Member Function | Board | parsePosition
+ *
+ * Summary :	Sets up a board from one line of position text, so that
+ *				positions can be read from files instead of being compiled
+ *				in. The text is the player to move, R or B, followed by a
+ *				field for each player: a colon, the player's letter and
+ *				its squares separated by commas. A king's square is
+ *				preceded by K, and a run of men may be written as a range.
+ *				For example, the initial board is "B:R1-12:B21-32" and
+ *				"R:R5,K29:B" is red to move with a man on 5, a king on 29
+ *				and no black pieces. Either field may be left out.
+ *				Trailing spaces and line endings are ignored.
+ *
+ *				The text is read in a single pass without allocating, so
+ *				files of many positions load quickly.
+ *
+ * @param string position :			The position text.
+ *
+ * @param Board &board :			Receives the position. It is left unchanged
+ *									if the text is not a valid position.
+ *
+ * @return bool :					True if the text was read. Unknown
+ *									characters, squares outside 1 - 32, a
+ *									square given twice and a man on the
+ *									row where it would have been kinged
+ *									are all rejected.
+ *
+ */
+bool Board::parsePosition(const std::string &position, Board &board)
+{
+	const char *text = position.c_str();
+	uint32_t redSquares = 0;
+	uint32_t blackSquares = 0;
+	uint32_t kings = 0;
+	Color positionSideToMove;
+
+	if (*text == 'R')
+	{
+		positionSideToMove = Color::RED;
+	}
+	else if (*text == 'B')
+	{
+		positionSideToMove = Color::BLACK;
+	}
+	else
+	{
+		return false;
+	}
+
+	text++;
+
+	while (*text == ':')
+	{
+		text++;
+
+		uint32_t *playerSquares;
+
+		if (*text == 'R')
+		{
+			playerSquares = &redSquares;
+		}
+		else if (*text == 'B')
+		{
+			playerSquares = &blackSquares;
+		}
+		else
+		{
+			return false;
+		}
+
+		text++;
+
+		// A player with no pieces has an empty field.
+		bool isFieldEmpty = (*text == ':' || *text == '\0' || *text == ' ' || *text == '\r' || *text == '\n');
+
+		while (!isFieldEmpty)
+		{
+			bool isKing = (*text == 'K');
+
+			if (isKing)
+			{
+				text++;
+			}
+
+			int firstSquare = parseSquare(text);
+			int lastSquare = firstSquare;
+
+			if (*text == '-' && !isKing)
+			{
+				text++;
+				lastSquare = parseSquare(text);
+			}
+
+			if (firstSquare == 0 || lastSquare < firstSquare)
+			{
+				return false;
+			}
+
+			for (int square = firstSquare; square <= lastSquare; square++)
+			{
+				uint32_t squareBit = 1U << (square - 1);
+
+				if ((redSquares | blackSquares) & squareBit)
+				{
+					return false;
+				}
+
+				*playerSquares |= squareBit;
+
+				if (isKing)
+				{
+					kings |= squareBit;
+				}
+			}
+
+			if (*text != ',')
+			{
+				break;
+			}
+
+			text++;
+		}
+	}
+
+	while (*text == ' ' || *text == '\r' || *text == '\n' || *text == '\t')
+	{
+		text++;
+	}
+
+	if (*text != '\0' ||
+		(redSquares & ~kings & RED_KING_ROW_MASK) != 0 ||
+		(blackSquares & ~kings & BLACK_KING_ROW_MASK) != 0)
+	{
+		return false;
+	}
+
+	board.redSquares = redSquares;
+	board.blackSquares = blackSquares;
+	board.kings = kings;
+	board.sideToMove = positionSideToMove;
+	board.hashKey = board.computeHashKey();
+
+	return true;
+}
+
+/**
+ * Member Function | Board | toPosition
+ *
+ * Summary :	Writes this board as position text, in the form read by
+ *				parsePosition. Squares are listed in ascending order and
+ *				ranges are not used, so a board always gives the same text.
+ *
+ * @return string :					The position text, for example
+ *									"B:R1,2,3,K29:B21,22,23".
+ *
+ */
+std::string Board::toPosition() const
+{
+	std::string position;
+	position.reserve(128);
+
+	position += (sideToMove == Color::RED) ? 'R' : 'B';
+	position += ":R";
+	appendSquares(position, redSquares, redSquares & kings);
+	position += ":B";
+	appendSquares(position, blackSquares, blackSquares & kings);
+
+	return position;
+}
+
+/**
+ * Member Function | Board | parseSquare, appendSquares
+ *
+ * Summary :	Read and write the squares of one player for the position
+ *				text. parseSquare reads a square number and moves the text
+ *				past it, returning 0 if there is no square 1 - 32 there.
+ *				appendSquares writes a comma separated list of squares,
+ *				marking the kings with K.
+ *
+ */
+int Board::parseSquare(const char *&text)
+{
+	int square = 0;
+	int numDigits = 0;
+
+	while (*text >= '0' && *text <= '9' && numDigits < 3)
+	{
+		square = square * 10 + (*text - '0');
+		text++;
+		numDigits++;
+	}
+
+	return (square >= 1 && square <= 32) ? square : 0;
+}
+
+void Board::appendSquares(std::string &position, uint32_t squares, uint32_t kings)
+{
+	bool isFirstSquare = true;
+
+	while (squares != 0)
+	{
+		int square = __builtin_ctz(squares) + 1;
+
+		if (!isFirstSquare)
+		{
+			position += ',';
+		}
+
+		if (kings & (1U << (square - 1)))
+		{
+			position += 'K';
+		}
+
+		if (square >= 10)
+		{
+			position += (char)('0' + square / 10);
+		}
+
+		position += (char)('0' + square % 10);
+
+		squares &= squares - 1;
+		isFirstSquare = false;
+	}
+}
+
+// Both colors are compiled here for the callers in other files.
+template Board::MoveList Board::moveGen<Color::RED>(bool collapseDuplicateCaptures);
+template Board::MoveList Board::moveGen<Color::BLACK>(bool collapseDuplicateCaptures);
+template uint32_t Board::getMovablePiecesMask<Color::RED>();
+template uint32_t Board::getMovablePiecesMask<Color::BLACK>();
+template uint32_t Board::getJumpingPiecesMask<Color::RED>();
+template uint32_t Board::getJumpingPiecesMask<Color::BLACK>();
+template bool Board::isLegal<Color::RED>(PackedMove move);
+template bool Board::isLegal<Color::BLACK>(PackedMove move);
+template uint32_t Board::getAttackedMask<Color::RED>() const;
+template uint32_t Board::getAttackedMask<Color::BLACK>() const;
+template uint32_t Board::getHangingMask<Color::RED>() const;
+template uint32_t Board::getHangingMask<Color::BLACK>() const;
+template void Board::makeMove<Color::RED>(PackedMove move, Undo &undo);
+template void Board::makeMove<Color::BLACK>(PackedMove move, Undo &undo);
+template void Board::unmakeMove<Color::RED>(PackedMove move, const Undo &undo);
+template void Board::unmakeMove<Color::BLACK>(PackedMove move, const Undo &undo);
+template void Board::getJumpsForPiece<Color::RED>(int square, MoveList &moves, bool collapseDuplicateCaptures);
+template void Board::getJumpsForPiece<Color::BLACK>(int square, MoveList &moves, bool collapseDuplicateCaptures);
+template void Board::getMovesForPiece<Color::RED>(int square, MoveList &moves);
+template void Board::getMovesForPiece<Color::BLACK>(int square, MoveList &moves);
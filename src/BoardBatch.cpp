@@ -0,0 +1,234 @@
+#include "BoardBatch.hpp"
+
+/**
+ * BoardBatch implementation
+ *
+ * Computes the piece masks of many boards at once. See BoardBatch.hpp.
+ */
+
+// The AVX2 path is compiled for x86 with GCC or Clang and picked at run time by isVectorized.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BOARDBATCH_AVX2 1
+#include <immintrin.h>
+#endif
+
+#ifdef BOARDBATCH_AVX2
+/**
+ * The masks Board uses for its diagonal steps, one copy per lane.
+ */
+struct StepMasks
+{
+    __m256i shiftedRow;
+    __m256i shiftedRowNoRightEdge;
+    __m256i unshiftedRow;
+    __m256i unshiftedRowNoLeftEdge;
+};
+
+/**
+ * The four Board step functions, for 8 boards at once. Each lane is stepped exactly as
+ * Board::stepDownLeft and the others step a single board.
+ */
+__attribute__((target("avx2"))) static inline __m256i stepDownLeft(__m256i squares, const StepMasks &masks)
+{
+    return _mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(squares, masks.shiftedRow), 4),
+                           _mm256_slli_epi32(_mm256_and_si256(squares, masks.unshiftedRowNoLeftEdge), 3));
+}
+
+__attribute__((target("avx2"))) static inline __m256i stepDownRight(__m256i squares, const StepMasks &masks)
+{
+    return _mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(squares, masks.shiftedRowNoRightEdge), 5),
+                           _mm256_slli_epi32(_mm256_and_si256(squares, masks.unshiftedRow), 4));
+}
+
+__attribute__((target("avx2"))) static inline __m256i stepUpLeft(__m256i squares, const StepMasks &masks)
+{
+    return _mm256_or_si256(_mm256_srli_epi32(_mm256_and_si256(squares, masks.shiftedRow), 4),
+                           _mm256_srli_epi32(_mm256_and_si256(squares, masks.unshiftedRowNoLeftEdge), 5));
+}
+
+__attribute__((target("avx2"))) static inline __m256i stepUpRight(__m256i squares, const StepMasks &masks)
+{
+    return _mm256_or_si256(_mm256_srli_epi32(_mm256_and_si256(squares, masks.shiftedRowNoRightEdge), 3),
+                           _mm256_srli_epi32(_mm256_and_si256(squares, masks.unshiftedRow), 4));
+}
+#endif
+
+BoardBatch::BoardBatch()
+{
+}
+
+BoardBatch::~BoardBatch()
+{
+}
+
+void BoardBatch::add(const Board &board)
+{
+    redSquares.push_back(board.redSquares);
+    blackSquares.push_back(board.blackSquares);
+    kings.push_back(board.kings);
+    redToMove.push_back(board.sideToMove == Color::RED ? 0xFFFFFFFF : 0);
+}
+
+void BoardBatch::clear()
+{
+    redSquares.clear();
+    blackSquares.clear();
+    kings.clear();
+    redToMove.clear();
+}
+
+int BoardBatch::size() const
+{
+    return redSquares.size();
+}
+
+Board BoardBatch::getBoard(int index) const
+{
+    Board board;
+
+    board.redSquares = redSquares[index];
+    board.blackSquares = blackSquares[index];
+    board.kings = kings[index];
+    board.sideToMove = redToMove[index] ? Color::RED : Color::BLACK;
+    board.hashKey = board.computeHashKey();
+
+    return board;
+}
+
+/**
+ * isVectorized reports whether computeMoveMasks can use AVX2 on the CPU it is running on.
+ *
+ * @return bool - true if 8 boards are handled per instruction
+ */
+bool BoardBatch::isVectorized()
+{
+#ifdef BOARDBATCH_AVX2
+    static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+    return hasAvx2;
+#else
+    return false;
+#endif
+}
+
+/**
+ * computeMoveMasks gives, for every board in the batch, the pieces of the side to move that can
+ * step and the pieces that can start a jump. The results are the same as the Board functions give
+ * for each board alone, bit for bit.
+ *
+ * @param std::vector<uint32_t> &movablePieces - returns Board::getMovablePiecesMask for each board
+ * @param std::vector<uint32_t> &jumpingPieces - returns Board::getJumpingPiecesMask for each board
+ */
+void BoardBatch::computeMoveMasks(std::vector<uint32_t> &movablePieces, std::vector<uint32_t> &jumpingPieces) const
+{
+    movablePieces.resize(size());
+    jumpingPieces.resize(size());
+
+    if (!isVectorized())
+    {
+        computeMoveMasksScalar(0, size(), movablePieces.data(), jumpingPieces.data());
+        return;
+    }
+
+    // Whole vectors first, then the boards left over one at a time
+    int vectorEnd = size() - size() % BOARDS_PER_VECTOR;
+
+    computeMoveMasksVector(0, vectorEnd, movablePieces.data(), jumpingPieces.data());
+    computeMoveMasksScalar(vectorEnd, size(), movablePieces.data(), jumpingPieces.data());
+}
+
+void BoardBatch::computeMoveMasksScalar(std::vector<uint32_t> &movablePieces, std::vector<uint32_t> &jumpingPieces) const
+{
+    movablePieces.resize(size());
+    jumpingPieces.resize(size());
+
+    computeMoveMasksScalar(0, size(), movablePieces.data(), jumpingPieces.data());
+}
+
+/**
+ * computeMoveMasksScalar works through boards first to last - 1 one at a time. The side to move
+ * is applied as a mask rather than a branch, the same way the vector version has to apply it.
+ * The arrays are read through local pointers, since the results are written through pointers
+ * the compiler cannot tell apart from the vectors' own storage.
+ */
+void BoardBatch::computeMoveMasksScalar(int first, int last, uint32_t *movablePieces, uint32_t *jumpingPieces) const
+{
+    const uint32_t *red = redSquares.data();
+    const uint32_t *black = blackSquares.data();
+    const uint32_t *allKings = kings.data();
+    const uint32_t *isRedToMove = redToMove.data();
+
+    for (int boardIter = first; boardIter < last; boardIter++)
+    {
+        uint32_t isRed = isRedToMove[boardIter];
+        uint32_t playerSquares = (red[boardIter] & isRed) | (black[boardIter] & ~isRed);
+        uint32_t opponentSquares = (black[boardIter] & isRed) | (red[boardIter] & ~isRed);
+        uint32_t emptySquares = ~(playerSquares | opponentSquares);
+        uint32_t playerKings = playerSquares & allKings[boardIter];
+
+        // Red men move "down" the board, black men move "up". Kings go both ways.
+        uint32_t movesDown = (playerSquares & isRed) | (playerKings & ~isRed);
+        uint32_t movesUp = (playerKings & isRed) | (playerSquares & ~isRed);
+
+        movablePieces[boardIter] =
+            ((Board::stepUpRight(emptySquares) | Board::stepUpLeft(emptySquares)) & movesDown) |
+            ((Board::stepDownRight(emptySquares) | Board::stepDownLeft(emptySquares)) & movesUp);
+
+        jumpingPieces[boardIter] =
+            (Board::stepUpRight(Board::stepUpRight(emptySquares) & opponentSquares) & movesDown) |
+            (Board::stepUpLeft(Board::stepUpLeft(emptySquares) & opponentSquares) & movesDown) |
+            (Board::stepDownRight(Board::stepDownRight(emptySquares) & opponentSquares) & movesUp) |
+            (Board::stepDownLeft(Board::stepDownLeft(emptySquares) & opponentSquares) & movesUp);
+    }
+}
+
+/**
+ * computeMoveMasksVector is computeMoveMasksScalar with 8 boards in each step. last - first must
+ * be a multiple of BOARDS_PER_VECTOR. Only called when isVectorized is true.
+ */
+#ifdef BOARDBATCH_AVX2
+__attribute__((target("avx2")))
+#endif
+void BoardBatch::computeMoveMasksVector(int first, int last, uint32_t *movablePieces, uint32_t *jumpingPieces) const
+{
+#ifdef BOARDBATCH_AVX2
+    StepMasks masks;
+    masks.shiftedRow = _mm256_set1_epi32(Board::SHIFTED_ROW_MASK);
+    masks.shiftedRowNoRightEdge = _mm256_set1_epi32(Board::SHIFTED_ROW_MASK & ~Board::RIGHT_EDGE_MASK);
+    masks.unshiftedRow = _mm256_set1_epi32(Board::UNSHIFTED_ROW_MASK);
+    masks.unshiftedRowNoLeftEdge = _mm256_set1_epi32(Board::UNSHIFTED_ROW_MASK & ~Board::LEFT_EDGE_MASK);
+
+    for (int boardIter = first; boardIter < last; boardIter += BOARDS_PER_VECTOR)
+    {
+        __m256i red = _mm256_loadu_si256((const __m256i *)&redSquares[boardIter]);
+        __m256i black = _mm256_loadu_si256((const __m256i *)&blackSquares[boardIter]);
+        __m256i isRed = _mm256_loadu_si256((const __m256i *)&redToMove[boardIter]);
+
+        // andnot(a, b) is ~a & b
+        __m256i playerSquares = _mm256_or_si256(_mm256_and_si256(red, isRed), _mm256_andnot_si256(isRed, black));
+        __m256i opponentSquares = _mm256_or_si256(_mm256_and_si256(black, isRed), _mm256_andnot_si256(isRed, red));
+        __m256i emptySquares = _mm256_xor_si256(_mm256_or_si256(red, black), _mm256_set1_epi32(-1));
+        __m256i playerKings = _mm256_and_si256(playerSquares,
+                                               _mm256_loadu_si256((const __m256i *)&kings[boardIter]));
+
+        __m256i movesDown = _mm256_or_si256(_mm256_and_si256(playerSquares, isRed), _mm256_andnot_si256(isRed, playerKings));
+        __m256i movesUp = _mm256_or_si256(_mm256_and_si256(playerKings, isRed), _mm256_andnot_si256(isRed, playerSquares));
+
+        __m256i movable = _mm256_or_si256(
+            _mm256_and_si256(_mm256_or_si256(stepUpRight(emptySquares, masks), stepUpLeft(emptySquares, masks)), movesDown),
+            _mm256_and_si256(_mm256_or_si256(stepDownRight(emptySquares, masks), stepDownLeft(emptySquares, masks)), movesUp));
+
+        __m256i jumpsDown = _mm256_or_si256(
+            stepUpRight(_mm256_and_si256(stepUpRight(emptySquares, masks), opponentSquares), masks),
+            stepUpLeft(_mm256_and_si256(stepUpLeft(emptySquares, masks), opponentSquares), masks));
+        __m256i jumpsUp = _mm256_or_si256(
+            stepDownRight(_mm256_and_si256(stepDownRight(emptySquares, masks), opponentSquares), masks),
+            stepDownLeft(_mm256_and_si256(stepDownLeft(emptySquares, masks), opponentSquares), masks));
+        __m256i jumping = _mm256_or_si256(_mm256_and_si256(jumpsDown, movesDown), _mm256_and_si256(jumpsUp, movesUp));
+
+        _mm256_storeu_si256((__m256i *)&movablePieces[boardIter], movable);
+        _mm256_storeu_si256((__m256i *)&jumpingPieces[boardIter], jumping);
+    }
+#else
+    computeMoveMasksScalar(first, last, movablePieces, jumpingPieces);
+#endif
+}
@@ -10,12 +10,16 @@ Game::~Game()
 {
 }
 
-Game::Game(bool player1MinMax, int evalVersionP1, bool player2MinMax, int evalVersionP2, int depth)
+Game::Game(bool player1MinMax, int evalVersionP1, bool player2MinMax, int evalVersionP2, int depth, int timePerMoveMs,
+           bool usePrincipalVariation)
 {
     state = Board();
-    state.InitializeMoveTable();
     redPlayer = Player(player1MinMax, Color::RED, depth, evalVersionP1);
     blackPlayer = Player(player2MinMax, Color::BLACK, depth, evalVersionP2);
+    redPlayer.setTimePerMove(timePerMoveMs);
+    blackPlayer.setTimePerMove(timePerMoveMs);
+    redPlayer.setPrincipalVariationSearch(usePrincipalVariation);
+    blackPlayer.setPrincipalVariationSearch(usePrincipalVariation);
 }
 
 Game::GameOver Game::startGame()
@@ -94,12 +98,18 @@ void Game::printNodes(Player player, std::string colorText)
         std::cout << colorText << " Leaf Nodes: " << player.minimaxLeafNodes << std::endl;
         std::cout << colorText << " Expanded Nodes: " << player.minimaxExpandedNodes << std::endl;
         std::cout << colorText << " Total Nodes: " << player.getMinimaxTotalNodes() << std::endl;
+        std::cout << colorText << " Quiescence Nodes: " << player.quiescenceNodes << std::endl;
     }
     else
     {
         std::cout << colorText << " Leaf Nodes: " << player.absearchLeafNodes << std::endl;
         std::cout << colorText << " Expanded Nodes: " << player.absearchExpandedNodes << std::endl;
         std::cout << colorText << " Total Nodes: " << player.getAbSearchTotalNodes() << std::endl;
+        std::cout << colorText << " Quiescence Nodes: " << player.quiescenceNodes << std::endl;
+        std::cout << colorText << " Aspiration Re-searches: " << player.aspirationFailLows << " fail low, "
+                  << player.aspirationFailHighs << " fail high" << std::endl;
+        std::cout << colorText << " Late Move Reductions: " << player.lateMoveReductions << ", re-searched "
+                  << player.lateMoveResearches << std::endl;
     }
     std::cout << std::endl;
 }
@@ -114,14 +124,12 @@ Color Game::changePlayer(Color currentPlayer)
 
 bool Game::doesBlackWin()
 {
-    std::vector<Board::Move> redMoves = state.moveGen(Color::RED);
-    return (redMoves.size() == 0);
+    return !state.hasAnyMove(Color::RED);
 }
 
 bool Game::doesRedWin()
 {
-    std::vector<Board::Move> blackMoves = state.moveGen(Color::BLACK);
-    return (blackMoves.size() == 0);
+    return !state.hasAnyMove(Color::BLACK);
 }
 
 bool Game::isItADraw()
@@ -0,0 +1,86 @@
+#include "MoveOrdering.hpp"
+
+/**
+ * MoveOrdering implementation
+ *
+ * Killer moves and history scores for ordering quiet moves. See MoveOrdering.hpp.
+ */
+
+MoveOrdering::MoveOrdering()
+{
+    clear();
+}
+
+MoveOrdering::~MoveOrdering()
+{
+}
+
+/**
+ * addCutoff learns from a move that caused a cutoff. Jumps are left out, since a position with a
+ * jump has nothing but jumps and they are ordered by the pieces they take. A quiet move becomes
+ * the first killer of its ply, the old first killer becoming the second, and its history score
+ * grows by depth * depth, so cutoffs high in the tree count for more than those near the leaves.
+ *
+ * @param Color color - the player who made the move
+ * @param Board::PackedMove move - the move that caused the cutoff
+ * @param int ply - how many plies the node is below the root
+ * @param int depth - how many plies were left to search below the node
+ */
+void MoveOrdering::addCutoff(Color color, Board::PackedMove move, int ply, int depth)
+{
+    if (move.isNull() || move.isCapture())
+        return;
+
+    if (ply >= 0 && ply < MAX_PLY && killers[ply][0] != move)
+    {
+        killers[ply][1] = killers[ply][0];
+        killers[ply][0] = move;
+    }
+
+    int &score = history[color == Color::RED ? 0 : 1][move.getStartSquare() - 1][move.getEndSquare() - 1];
+    score += depth * depth;
+
+    // Halving keeps the order of the scores while making room for new ones
+    if (score >= HISTORY_LIMIT)
+    {
+        for (int colorIter = 0; colorIter < 2; colorIter++)
+            for (int startIter = 0; startIter < 32; startIter++)
+                for (int endIter = 0; endIter < 32; endIter++)
+                    history[colorIter][startIter][endIter] /= 2;
+    }
+}
+
+/**
+ * getKiller gives one of the killer moves of a ply, the null move if there is none.
+ */
+Board::PackedMove MoveOrdering::getKiller(int ply, int killerIndex) const
+{
+    if (ply < 0 || ply >= MAX_PLY)
+        return Board::PackedMove();
+
+    return killers[ply][killerIndex];
+}
+
+/**
+ * getHistoryScore gives the history score of a quiet move, higher for moves that caused more and
+ * deeper cutoffs.
+ */
+int MoveOrdering::getHistoryScore(Color color, Board::PackedMove move) const
+{
+    return history[color == Color::RED ? 0 : 1][move.getStartSquare() - 1][move.getEndSquare() - 1];
+}
+
+/**
+ * clear forgets every killer move and history score.
+ */
+void MoveOrdering::clear()
+{
+    for (int plyIter = 0; plyIter < MAX_PLY; plyIter++)
+        for (int killerIter = 0; killerIter < KILLERS_PER_PLY; killerIter++)
+            killers[plyIter][killerIter] = Board::PackedMove();
+
+    for (int colorIter = 0; colorIter < 2; colorIter++)
+        for (int startIter = 0; startIter < 32; startIter++)
+            for (int endIter = 0; endIter < 32; endIter++)
+                history[colorIter][startIter][endIter] = 0;
+}
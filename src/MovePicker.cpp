@@ -0,0 +1,260 @@
+#include "MovePicker.hpp"
+
+/**
+ * MovePicker implementation
+ *
+ * Builds the moves of a position lazily, one piece at a time. See MovePicker.hpp.
+ */
+
+/**
+ * Constructor for MovePicker. Decides the stage from the piece masks alone, so nothing is built
+ * until the first call to nextMove.
+ *
+ * @param Board &state - the position to pick moves for, with the template color to move
+ * @param bool collapseDuplicateCaptures - if true, jump routes leading to the same position are handed out once
+ */
+template <Color color>
+MovePicker<color>::MovePicker(Board &state, bool collapseDuplicateCaptures)
+    : MovePicker(state, collapseDuplicateCaptures, NULL, Board::PackedMove(), 0)
+{
+}
+
+/**
+ * Constructor for an ordered MovePicker. See MovePicker.hpp for the order moves come out in.
+ *
+ * @param Board &state - the position to pick moves for, with the template color to move
+ * @param bool collapseDuplicateCaptures - if true, jump routes leading to the same position are handed out once
+ * @param const MoveOrdering *ordering - the killer moves and history scores to order by, or null for generation order
+ * @param Board::PackedMove hashMove - the move to try first, usually from the transposition table; may be null or illegal
+ * @param int ply - how many plies the position is below the root
+ */
+template <Color color>
+MovePicker<color>::MovePicker(Board &state, bool collapseDuplicateCaptures, const MoveOrdering *ordering,
+                              Board::PackedMove hashMove, int ply)
+    : state(state), collapseDuplicateCaptures(collapseDuplicateCaptures), ordering(ordering), hashMove(hashMove), ply(ply)
+{
+    pieceMoveIndex = 0;
+    numPiecesGenerated = 0;
+    killerIndex = 0;
+    numOrderedMoves = 0;
+    orderedMoveIndex = 0;
+
+    // Any jump makes jumping mandatory, so quiet moves are only needed without one
+    piecesLeft = state.getJumpingPiecesMask<color>();
+
+    if (piecesLeft != 0)
+    {
+        stage = JUMPS;
+    }
+    else
+    {
+        piecesLeft = state.getMovablePiecesMask<color>();
+        stage = (piecesLeft != 0) ? QUIET_MOVES : DONE;
+    }
+
+    numPiecesToGenerate = __builtin_popcount(piecesLeft);
+    hasJumps = (stage == JUMPS);
+
+    if (ordering != NULL && stage != DONE)
+        stage = HASH_MOVE;
+}
+
+template <Color color>
+MovePicker<color>::~MovePicker()
+{
+}
+
+/**
+ * nextMove hands out the next move of the position. When the moves of the current piece are used
+ * up, the moves of the next piece are built.
+ *
+ * @param Board::PackedMove &move - returns the next move
+ *
+ * @return bool - true if a move was returned, false if there are no moves left
+ */
+template <Color color>
+bool MovePicker<color>::nextMove(Board::PackedMove &move)
+{
+    if (ordering != NULL)
+        return nextOrderedMove(move);
+
+    while (pieceMoveIndex >= pieceMoves.size())
+    {
+        if (piecesLeft == 0)
+        {
+            stage = DONE;
+            return false;
+        }
+
+        // The board in checkers is 1 - 32, so add the offset back
+        int square = __builtin_ctz(piecesLeft) + 1;
+        piecesLeft &= piecesLeft - 1;
+
+        pieceMoves.clear();
+        pieceMoveIndex = 0;
+
+        if (stage == JUMPS)
+            state.getJumpsForPiece<color>(square, pieceMoves, collapseDuplicateCaptures);
+        else
+            state.getMovesForPiece<color>(square, pieceMoves);
+
+        numPiecesGenerated++;
+    }
+
+    move = Board::packMove(pieceMoves.at(pieceMoveIndex++));
+    return true;
+}
+
+/**
+ * nextOrderedMove is nextMove for an ordered picker. The hash move and the killers are checked for
+ * legality rather than built, so a cutoff on one of them builds no moves at all. Killers are quiet
+ * moves and are skipped when the position has a jump, since jumping is mandatory.
+ *
+ * @param Board::PackedMove &move - returns the next move
+ *
+ * @return bool - true if a move was returned, false if there are no moves left
+ */
+template <Color color>
+bool MovePicker<color>::nextOrderedMove(Board::PackedMove &move)
+{
+    while (stage != DONE)
+    {
+        if (stage == HASH_MOVE)
+        {
+            stage = hasJumps ? JUMPS : KILLER_MOVES;
+
+            if (!hashMove.isNull() && state.isLegal<color>(hashMove))
+            {
+                move = hashMove;
+                return true;
+            }
+
+            // not handed out, so there is nothing to skip later
+            hashMove = Board::PackedMove();
+        }
+        else if (stage == KILLER_MOVES)
+        {
+            while (killerIndex < MoveOrdering::KILLERS_PER_PLY)
+            {
+                Board::PackedMove killer = ordering->getKiller(ply, killerIndex++);
+
+                if (!killer.isNull() && killer != hashMove && state.isLegal<color>(killer))
+                {
+                    move = killer;
+                    return true;
+                }
+            }
+
+            stage = QUIET_MOVES;
+        }
+        else
+        {
+            if (piecesLeft != 0)
+                buildOrderedMoves();
+
+            if (orderedMoveIndex < numOrderedMoves)
+            {
+                // Selection sort, one move per call, since a cutoff often leaves most unsorted
+                int bestIndex = orderedMoveIndex;
+
+                for (int moveIter = orderedMoveIndex + 1; moveIter < numOrderedMoves; moveIter++)
+                {
+                    if (orderedScores[moveIter] > orderedScores[bestIndex])
+                        bestIndex = moveIter;
+                }
+
+                move = orderedMoves[bestIndex];
+                orderedMoves[bestIndex] = orderedMoves[orderedMoveIndex];
+                orderedScores[bestIndex] = orderedScores[orderedMoveIndex];
+                orderedMoveIndex++;
+                return true;
+            }
+
+            stage = DONE;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * buildOrderedMoves builds the moves of every piece left in the current stage and scores them:
+ * jumps by the number of pieces they take, quiet moves by their history score. Moves already
+ * handed out as the hash move or a killer are left out. A killer that matches a quiet move here
+ * was legal, so it was handed out unless it was the hash move, which is left out anyway.
+ */
+template <Color color>
+void MovePicker<color>::buildOrderedMoves()
+{
+    Board::PackedMove skippedKillers[MoveOrdering::KILLERS_PER_PLY];
+    bool isHashMoveSkipped = hashMove.isNull();
+
+    for (int killerIter = 0; killerIter < MoveOrdering::KILLERS_PER_PLY; killerIter++)
+        skippedKillers[killerIter] = (stage == QUIET_MOVES) ? ordering->getKiller(ply, killerIter) : Board::PackedMove();
+
+    pieceMoves.clear();
+    numPiecesGenerated += __builtin_popcount(piecesLeft);
+
+    while (piecesLeft != 0)
+    {
+        // The board in checkers is 1 - 32, so add the offset back
+        int square = __builtin_ctz(piecesLeft) + 1;
+        piecesLeft &= piecesLeft - 1;
+
+        if (stage == JUMPS)
+            state.getJumpsForPiece<color>(square, pieceMoves, collapseDuplicateCaptures);
+        else
+            state.getMovesForPiece<color>(square, pieceMoves);
+    }
+
+    for (int moveIter = 0; moveIter < pieceMoves.size(); moveIter++)
+    {
+        Board::PackedMove packed = Board::packMove(pieceMoves.at(moveIter));
+        bool isSkipped = false;
+
+        // Only one copy is left out, in case duplicate routes were not collapsed
+        if (!isHashMoveSkipped && packed == hashMove)
+        {
+            isHashMoveSkipped = true;
+            isSkipped = true;
+        }
+
+        for (int killerIter = 0; killerIter < MoveOrdering::KILLERS_PER_PLY && !isSkipped; killerIter++)
+        {
+            if (!skippedKillers[killerIter].isNull() && packed == skippedKillers[killerIter])
+            {
+                skippedKillers[killerIter] = Board::PackedMove();
+                isSkipped = true;
+            }
+        }
+
+        if (isSkipped)
+            continue;
+
+        orderedMoves[numOrderedMoves] = packed;
+        orderedScores[numOrderedMoves] = (stage == JUMPS) ? __builtin_popcount(packed.getCapturedSquares())
+                                                          : ordering->getHistoryScore(color, packed);
+        numOrderedMoves++;
+    }
+}
+
+template <Color color>
+typename MovePicker<color>::Stage MovePicker<color>::getStage()
+{
+    return stage;
+}
+
+template <Color color>
+int MovePicker<color>::getNumPiecesGenerated()
+{
+    return numPiecesGenerated;
+}
+
+template <Color color>
+int MovePicker<color>::getNumPiecesToGenerate()
+{
+    return numPiecesToGenerate;
+}
+
+template class MovePicker<Color::RED>;
+template class MovePicker<Color::BLACK>;
@@ -0,0 +1,155 @@
+#include "Perft.hpp"
+
+#include <atomic>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+/**
+ * Perft implementation
+ *
+ * Counts the positions reached by every legal move sequence to a fixed depth. See Perft.hpp.
+ */
+
+// Index 0 is the position itself. The counts follow the rules this engine plays by: jumps are
+// mandatory, a jump chain is carried out to the end and becoming a king ends the chain.
+const long long Perft::INITIAL_POSITION_COUNTS[NUM_KNOWN_COUNTS + 1] = {
+    1, 7, 49, 302, 1469, 7361, 36768, 179740, 845931, 3963680, 18391564, 85242128, 388623673};
+
+Perft::Perft()
+{
+}
+
+Perft::~Perft()
+{
+}
+
+/**
+ * countNodes walks every move sequence depth plies deep, making and taking back moves on state.
+ *
+ * @param Board &state - the position to count from; it is unchanged on return
+ * @param Color color - the player to move
+ * @param int depth - how many plies to walk
+ * @param bool bulkCount - if true, the moves at the last ply are counted without being played
+ *
+ * @return long long - the number of positions at depth plies
+ */
+long long Perft::countNodes(Board &state, Color color, int depth, bool bulkCount)
+{
+    if (color == Color::RED)
+        return countNodes<Color::RED>(state, depth, bulkCount);
+    else
+        return countNodes<Color::BLACK>(state, depth, bulkCount);
+}
+
+template <Color color>
+long long Perft::countNodes(Board &state, int depth, bool bulkCount)
+{
+    if (depth == 0)
+        return 1;
+
+    Board::MoveList moves = state.moveGen<color>();
+
+    if (bulkCount && depth == 1)
+        return moves.size();
+
+    long long numNodes = 0;
+
+    for (int moveIter = 0; moveIter < moves.size(); moveIter++)
+    {
+        Board::PackedMove move = Board::packMove(moves.at(moveIter));
+        Board::Undo undo;
+
+        state.makeMove<color>(move, undo);
+        numNodes += countNodes<Board::getOpponentColor(color)>(state, depth - 1, bulkCount);
+        state.unmakeMove<color>(move, undo);
+    }
+
+    return numNodes;
+}
+
+/**
+ * countNodesThreaded gives the same count as countNodes, with the root moves shared among threads.
+ * Each thread plays the next root move nobody has taken yet on its own copy of the board and counts
+ * below it, so a thread that finishes early picks up more work.
+ *
+ * @param const Board &state - the position to count from
+ * @param Color color - the player to move
+ * @param int depth - how many plies to walk
+ * @param bool bulkCount - if true, the moves at the last ply are counted without being played
+ * @param int numThreads - how many threads to count on
+ *
+ * @return long long - the number of positions at depth plies
+ */
+long long Perft::countNodesThreaded(const Board &state, Color color, int depth, bool bulkCount, int numThreads)
+{
+    Board rootState = state;
+
+    if (numThreads <= 1 || depth <= 1)
+        return countNodes(rootState, color, depth, bulkCount);
+
+    Board::MoveList rootMoves = rootState.moveGen(color);
+    std::atomic<int> nextRootMove(0);
+    std::atomic<long long> numNodes(0);
+    std::vector<std::thread> threads;
+
+    for (int threadIter = 0; threadIter < numThreads; threadIter++)
+    {
+        threads.push_back(std::thread([&]() {
+            long long threadNodes = 0;
+
+            for (int moveIter = nextRootMove++; moveIter < rootMoves.size(); moveIter = nextRootMove++)
+            {
+                Board threadState = rootState.updateBoard(rootMoves.at(moveIter), color);
+                threadNodes += countNodes(threadState, Board::getOpponentColor(color), depth - 1, bulkCount);
+            }
+
+            numNodes += threadNodes;
+        }));
+    }
+
+    for (int threadIter = 0; threadIter < numThreads; threadIter++)
+        threads[threadIter].join();
+
+    return numNodes.load();
+}
+
+/**
+ * run counts every depth from 1 to maxDepth and prints the count, the time taken and the nodes per
+ * second. When the position is the initial board with Black to move, each count is also checked
+ * against the published count for that depth.
+ *
+ * @param const Board &state - the position to count from
+ * @param Color color - the player to move
+ * @param int maxDepth - the deepest depth to count
+ * @param int numThreads - how many threads to count on
+ * @param bool bulkCount - if true, the moves at the last ply are counted without being played
+ */
+void Perft::run(const Board &state, Color color, int maxDepth, int numThreads, bool bulkCount)
+{
+    bool isInitialPosition = (color == Color::BLACK && state.toPosition() == Board().toPosition());
+
+    std::cout << "Perft of " << state.toPosition() << " to depth " << maxDepth << " on " << numThreads << " thread(s)"
+              << (bulkCount ? ", bulk counting the last ply" : "") << std::endl;
+
+    for (int depth = 1; depth <= maxDepth; depth++)
+    {
+        auto t1 = high_resolution_clock::now();
+        long long numNodes = countNodesThreaded(state, color, depth, bulkCount, numThreads);
+        auto t2 = high_resolution_clock::now();
+        duration<double> elapsed = t2 - t1;
+
+        std::cout << "  depth " << depth << ": " << numNodes << " nodes, " << elapsed.count() * 1000 << " ms, "
+                  << (elapsed.count() > 0 ? (long long)(numNodes / elapsed.count()) : 0) << " nodes/s";
+
+        if (isInitialPosition && depth <= NUM_KNOWN_COUNTS)
+        {
+            if (numNodes == INITIAL_POSITION_COUNTS[depth])
+                std::cout << ", matches";
+            else
+                std::cout << ", MISMATCH, expected " << INITIAL_POSITION_COUNTS[depth];
+        }
+
+        std::cout << std::endl;
+    }
+}
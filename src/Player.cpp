@@ -9,6 +9,11 @@ duration<double, std::milli> Player::mini_time;
 
 Player::Player()
 {
+    timePerMoveMs = 0;
+    lastSearchDepth = 0;
+    usePrincipalVariation = false;
+    evaluationPhase = 0;
+    clearSearchScores();
 }
 Player::~Player()
 {
@@ -23,56 +28,206 @@ Player::Player(bool minMaxState, Color color, int depth, int evalVersion)
     isMinimax = minMaxState;
     this->depth = depth;
     this->evalVersion = evalVersion;
+    this->transpositionTable = std::make_shared<TranspositionTable>();
+    this->evaluationPhase = 0;
+    this->timePerMoveMs = 0;
+    this->lastSearchDepth = 0;
+    this->usePrincipalVariation = false;
 
     this->minimaxExpandedNodes = 0;
     this->minimaxLeafNodes = 0;
     this->absearchExpandedNodes = 0;
     this->absearchLeafNodes = 0;
+    this->quiescenceNodes = 0;
+    this->aspirationFailLows = 0;
+    this->aspirationFailHighs = 0;
+    this->lateMoveReductions = 0;
+    this->lateMoveResearches = 0;
+
+    clearSearchScores();
 }
 
 int Player::takeTurn(Board &state)
+{
+    Board::PackedMove searchedMove;
+
+    // scores kept from turns before the evaluation changed its weights would mislead the search
+    int phase = Algorithm::getEvaluationPhase(evalVersion, numTurnsTaken);
+    if (phase != evaluationPhase)
+    {
+        if (transpositionTable)
+            transpositionTable->clear();
+        clearSearchScores();
+        evaluationPhase = phase;
+    }
+
+    if (timePerMoveMs > 0)
+    {
+        searchedMove = searchWithTimeBudget(state);
+    }
+    else
+    {
+        searchToDepth(state, this->depth, false, high_resolution_clock::time_point(), searchedMove);
+        lastSearchDepth = this->depth;
+    }
+
+    // the search works with packed moves; get the full move back for printing
+    Board::Move bestMove = state.unpackMove(searchedMove, this->color);
+
+    if (bestMove.destinationSquare.size() == 0)
+    {
+        didPlayerMove = false; // Player did not make a turn
+    }
+    else
+    {
+        state = state.updateBoard(bestMove, this->color);
+        printMove(bestMove, this->color, true);
+        if (timePerMoveMs > 0)
+            std::cout << "  searched to depth " << lastSearchDepth << " in the " << timePerMoveMs << " ms budget" << std::endl;
+        numTurnsTaken++;      // incremente Player's own turn counter
+        didPlayerMove = true; // return true as player did make a turn
+        state.printBoard();
+    }
+
+    // return how many pieces the player took during their turn
+    return bestMove.removalSquare.size();
+}
+
+/**
+ * searchToDepth runs one search of the player's algorithm and adds its time and node counts to
+ * the player's totals.
+ *
+ * @param Board &state - the position to search; it is unchanged on return
+ * @param int searchDepth - how many plies to search
+ * @param bool hasDeadline - if true, the search stops at deadline
+ * @param time_point deadline - when to stop
+ * @param Board::PackedMove &bestMove - returns the move found
+ *
+ * @return bool - true if the search finished; if false, bestMove must not be played
+ */
+bool Player::searchToDepth(Board &state, int searchDepth, bool hasDeadline, high_resolution_clock::time_point deadline,
+                           Board::PackedMove &bestMove)
 {
     Algorithm::Result result;
-    Algorithm *algorithm = new Algorithm(evalVersion, depth, *this);
+    Algorithm algorithm(evalVersion, searchDepth, *this);
+    int expectedValue;
+
+    if (hasDeadline)
+        algorithm.setDeadline(deadline);
+
+    if (!isMinimax && getExpectedValue(searchDepth, expectedValue))
+        algorithm.setExpectedValue(expectedValue);
 
     if (isMinimax)
     {
+        // the search makes and takes back moves on a single board of its own
+        Board searchState = state;
+
         auto t1 = high_resolution_clock::now();
-        result = algorithm->minimax_a_b(state, this->depth, this->color, 9000000, -8000000);
+        result = algorithm.minimax_a_b(searchState, searchDepth, this->color, 9000000, -8000000);
         auto t2 = high_resolution_clock::now();
 
-        Player::mini_time += (t2 - t1); 
-        
-        this->minimaxExpandedNodes += algorithm->minimaxExpandedNodes;
-        this->minimaxLeafNodes += algorithm->minimaxLeafNodes;
+        Player::mini_time += (t2 - t1);
+
+        this->minimaxExpandedNodes += algorithm.minimaxExpandedNodes;
+        this->minimaxLeafNodes += algorithm.minimaxLeafNodes;
     }
     else
     {
         auto t1 = high_resolution_clock::now();
-        result = algorithm->alphaBetaSearch(state);
+        if (usePrincipalVariation)
+            result = algorithm.principalVariationSearch(state);
+        else
+            result = algorithm.alphaBetaSearch(state);
         auto t2 = high_resolution_clock::now();
 
-        Player::abs_time += (t2 - t1); 
+        Player::abs_time += (t2 - t1);
 
-        this->absearchExpandedNodes += algorithm->absearchExpandedNodes;
-        this->absearchLeafNodes += algorithm->absearchLeafNodes;
+        this->absearchExpandedNodes += algorithm.absearchExpandedNodes;
+        this->absearchLeafNodes += algorithm.absearchLeafNodes;
+        this->aspirationFailLows += algorithm.aspirationFailLows;
+        this->aspirationFailHighs += algorithm.aspirationFailHighs;
+        this->lateMoveReductions += algorithm.lateMoveReductions;
+        this->lateMoveResearches += algorithm.lateMoveResearches;
+
+        if (!algorithm.wasStopped() && searchDepth <= MAX_SEARCH_DEPTH)
+        {
+            searchScores[searchDepth] = result.value;
+            searchScoreTurns[searchDepth] = numTurnsTaken;
+        }
     }
 
-    if (result.bestMove.destinationSquare.size() == 0)
+    this->quiescenceNodes += algorithm.quiescenceNodes;
+
+    bestMove = result.bestMove;
+    return !algorithm.wasStopped();
+}
+
+/**
+ * getExpectedValue picks the score to centre a search's aspiration window on. Scores of the same
+ * depth parity are comparable, see Algorithm::setExpectedValue. Best is a search two plies
+ * shallower from this turn, as iterative deepening makes; next best is a search as deep from the
+ * player's last turn.
+ *
+ * @param int searchDepth - the depth about to be searched
+ * @param int &expectedValue - returns the score to expect
+ *
+ * @return bool - true if there was an earlier search to go by
+ */
+bool Player::getExpectedValue(int searchDepth, int &expectedValue)
+{
+    if (searchDepth - 2 >= 1 && searchDepth - 2 <= MAX_SEARCH_DEPTH && searchScoreTurns[searchDepth - 2] == numTurnsTaken)
     {
-        didPlayerMove = false; // Player did not make a turn
+        expectedValue = searchScores[searchDepth - 2];
+        return true;
     }
-    else
+
+    if (searchDepth <= MAX_SEARCH_DEPTH && searchScoreTurns[searchDepth] == numTurnsTaken - 1)
     {
-        state = state.updateBoard(result.bestMove, this->color);
-        printMove(result.bestMove, this->color, true);
-        numTurnsTaken++;      // incremente Player's own turn counter
-        didPlayerMove = true; // return true as player did make a turn
-        state.printBoard();
+        expectedValue = searchScores[searchDepth];
+        return true;
     }
 
-    // return how many pieces the player took during their turn
-    return result.bestMove.removalSquare.size();
+    return false;
+}
+
+void Player::clearSearchScores()
+{
+    for (int depthIter = 0; depthIter <= MAX_SEARCH_DEPTH; depthIter++)
+    {
+        searchScores[depthIter] = 0;
+        searchScoreTurns[depthIter] = -2; // no turn is -2 or one before it
+    }
+}
+
+/**
+ * searchWithTimeBudget searches to depth 1, 2, 3 and so on until the time per move runs out or
+ * the player's depth is reached, and returns the best move of the deepest search that finished.
+ * A search still running at the deadline is stopped and its move thrown away. Each search fills
+ * the transposition table for the next. Depth 1 has no deadline, so there is always a move.
+ *
+ * @param Board &state - the position to search
+ *
+ * @return Board::PackedMove - the move to play
+ */
+Board::PackedMove Player::searchWithTimeBudget(Board &state)
+{
+    high_resolution_clock::time_point deadline = high_resolution_clock::now() + milliseconds(timePerMoveMs);
+    Board::PackedMove bestMove, iterationMove;
+
+    for (int searchDepth = 1; searchDepth <= this->depth; searchDepth++)
+    {
+        if (!searchToDepth(state, searchDepth, searchDepth > 1, deadline, iterationMove))
+            break;
+
+        bestMove = iterationMove;
+        lastSearchDepth = searchDepth;
+
+        if (high_resolution_clock::now() >= deadline)
+            break;
+    }
+
+    return bestMove;
 }
 
 int Player::getNumPieces()
@@ -100,6 +255,41 @@ Color Player::getColor()
     return color;
 }
 
+std::shared_ptr<TranspositionTable> Player::getTranspositionTable()
+{
+    return transpositionTable;
+}
+
+void Player::setTranspositionTable(std::shared_ptr<TranspositionTable> transpositionTable)
+{
+    this->transpositionTable = transpositionTable;
+}
+
+void Player::setTimePerMove(int timePerMoveMs)
+{
+    this->timePerMoveMs = timePerMoveMs;
+}
+
+int Player::getTimePerMove()
+{
+    return timePerMoveMs;
+}
+
+int Player::getLastSearchDepth()
+{
+    return lastSearchDepth;
+}
+
+void Player::setPrincipalVariationSearch(bool usePrincipalVariation)
+{
+    this->usePrincipalVariation = usePrincipalVariation;
+}
+
+bool Player::getPrincipalVariationSearch()
+{
+    return usePrincipalVariation;
+}
+
 void Player::decreaseNumPieces(int numPiecesToDecreaseCount)
 {
     numPieces -= numPiecesToDecreaseCount;
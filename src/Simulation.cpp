@@ -15,12 +15,33 @@
 Simulation::Simulation()
 {
     this->numGamesPlayed = 0;
+    this->timePerMoveMs = 0;
+    this->usePrincipalVariation = false;
 }
 
 Simulation::~Simulation()
 {
 }
 
+/**
+ * Gives every computer move of the games that follow a time budget. The players deepen their
+ * search until it runs out, never past the depth of the game.
+ * @param int timePerMoveMs - milliseconds per move, 0 to always search to the full depth
+ */
+void Simulation::setTimePerMove(int timePerMoveMs)
+{
+    this->timePerMoveMs = timePerMoveMs;
+}
+
+/**
+ * Has the AB Prune players of the games that follow search with Principal Variation Search.
+ * @param bool usePrincipalVariation - true for Principal Variation Search, false for alpha-beta search
+ */
+void Simulation::setPrincipalVariationSearch(bool usePrincipalVariation)
+{
+    this->usePrincipalVariation = usePrincipalVariation;
+}
+
 /**
 * Runs all games runs as delineated in Simulation.hpp
 * R = redundant game simulated 
@@ -78,7 +99,7 @@ void Simulation::runFullSimulation()
                         std::cout << "p1_alg: " << p1_alg << " p1_eval: " << p1_eval << " p2_alg: "
                                   << p2_alg << " p2_eval: " << p2_eval << std::endl;
 
-                        Game *game = new Game(p1_alg, p1_eval, p2_alg, p2_eval, depth);
+                        Game *game = new Game(p1_alg, p1_eval, p2_alg, p2_eval, depth, timePerMoveMs, usePrincipalVariation);
                         Game::GameOver endGameStatus = game->startGame();
                         numGamesPlayed++;
                         printGameResults(endGameStatus); 
@@ -115,7 +136,8 @@ void Simulation::runSpecificSimulation(int redPlayerAlg, int redPlayerEvalFunct,
     if (depth <= 1 || depth > 15)
         throw std::runtime_error("Error: depth must be > 1 and <= 15. ");
 
-    Game *game = new Game(redPlayerAlg, redPlayerEvalFunct, blackPlayerAlg, blackPlayerEvalFunct, depth);
+    Game *game = new Game(redPlayerAlg, redPlayerEvalFunct, blackPlayerAlg, blackPlayerEvalFunct, depth, timePerMoveMs,
+                          usePrincipalVariation);
     Game::GameOver endGameStatus = game->startGame();
 
     printGameResults(endGameStatus);
@@ -151,6 +173,8 @@ void Simulation::runPlayerVsAISimulation(int playerAlg, int playerEvalFunct, int
 {
 
     Player computerPlayer = Player(playerAlg, Color::RED, depth, playerEvalFunct);
+    computerPlayer.setTimePerMove(timePerMoveMs);
+    computerPlayer.setPrincipalVariationSearch(usePrincipalVariation);
     bool gameOver = false;
     int moveSelection;
     Color computerPlayerColor = Color::RED;
@@ -163,7 +187,7 @@ void Simulation::runPlayerVsAISimulation(int playerAlg, int playerEvalFunct, int
     {
         if (currentPlayerColor == humanPlayerColor) // BLACK
         {
-            std::vector<Board::Move> blackMoves = board.moveGen(humanPlayerColor);
+            Board::MoveList blackMoves = board.moveGen(humanPlayerColor);
             // PRINT OUT BLACK'S MOVES
             std::cout << "Black's moves (b/B): ";
             for (int blackMoveIter = 0; blackMoveIter < blackMoves.size(); blackMoveIter++)
@@ -222,6 +246,10 @@ void Simulation::printGameConfig(int redPlayerAlg, int redPlayerEvalFunct, int b
     std::cout << "Red player alg: " << algs[redPlayerAlg] << ", eval: " << redPlayerEvalFunct << std::endl;
     std::cout << "Black player alg: " << algs[blackPlayerAlg] << ", eval: " << blackPlayerEvalFunct << std::endl;
     std::cout << "Depth: " << depth << std::endl;
+    if (timePerMoveMs > 0)
+        std::cout << "Time per move: " << timePerMoveMs << "ms" << std::endl;
+    if (usePrincipalVariation)
+        std::cout << "Alpha-Beta-Search runs as Principal Variation Search" << std::endl;
     std::cout << "Minimax-a-b took: " << Player::mini_time.count() << "ms" << std::endl; 
     std::cout << "ABSearch took: " << Player::abs_time.count() << "ms" << std::endl; 
 }
@@ -235,15 +263,13 @@ void Simulation::printGameConfig(int redPlayerAlg, int redPlayerEvalFunct, int b
 bool Simulation::didSomeoneWin(Board board)
 {
     bool isGameOver = false;
-    std::vector<Board::Move> redMoves = board.moveGen(Color::RED);
-    std::vector<Board::Move> blackMoves = board.moveGen(Color::BLACK);
 
-    if (blackMoves.size() == 0)
+    if (!board.hasAnyMove(Color::BLACK))
     {
         isGameOver = true;
         printRedWins();
     }
-    else if (redMoves.size() == 0)
+    else if (!board.hasAnyMove(Color::RED))
     {
         isGameOver = true;
         printBlackWins();
@@ -0,0 +1,159 @@
+#include "TranspositionTable.hpp"
+
+#include <new>
+
+/**
+ * TranspositionTable implementation
+ *
+ * A fixed size table of search results, one cache line per bucket. See TranspositionTable.hpp.
+ */
+
+/**
+ * Constructor for TranspositionTable. The number of buckets is the largest power of two that fits
+ * in the size given, at least one, so a bucket is picked by masking the key. Every entry starts
+ * out empty.
+ *
+ * @param size_t sizeInMegabytes - the most memory the table may take
+ * @param ReplacementPolicy policy - which entry a new result may take in a full bucket
+ */
+TranspositionTable::TranspositionTable(size_t sizeInMegabytes, ReplacementPolicy policy)
+    : policy(policy), generation(0)
+{
+    size_t numBuckets = 1;
+
+    while (numBuckets * 2 * sizeof(Bucket) <= sizeInMegabytes * 1024 * 1024)
+        numBuckets *= 2;
+
+    bucketMask = numBuckets - 1;
+
+    // new char[] only promises the alignment of a plain type, so line the buckets up by hand
+    memory.reset(new char[numBuckets * sizeof(Bucket) + alignof(Bucket) - 1]);
+    uintptr_t address = reinterpret_cast<uintptr_t>(memory.get());
+    buckets = reinterpret_cast<Bucket *>((address + alignof(Bucket) - 1) & ~(uintptr_t)(alignof(Bucket) - 1));
+
+    for (size_t bucketIter = 0; bucketIter < numBuckets; bucketIter++)
+        new (&buckets[bucketIter]) Bucket();
+}
+
+TranspositionTable::~TranspositionTable()
+{
+}
+
+/**
+ * probe looks for a position in its bucket. The bucket is chosen by the low bits of the key and
+ * the entry is matched on the high 32 bits, so a wrong match needs two positions that agree on
+ * both, which is rare enough that the searches do not check the stored move further.
+ *
+ * @param uint64_t key - the Board hash key of the position
+ * @param Entry &entry - returns the stored entry when there is one
+ *
+ * @return bool - true if the position was found
+ */
+bool TranspositionTable::probe(uint64_t key, Entry &entry) const
+{
+    const Bucket &bucket = buckets[key & bucketMask];
+    uint32_t keyCheck = (uint32_t)(key >> 32);
+
+    for (int entryIter = 0; entryIter < ENTRIES_PER_BUCKET; entryIter++)
+    {
+        if (bucket.entries[entryIter].keyCheck == keyCheck && bucket.entries[entryIter].bound != NO_BOUND)
+        {
+            entry = bucket.entries[entryIter];
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * store keeps the result of a search of a position. An entry already holding the position is
+ * updated. Otherwise the new result takes an empty entry, then one left by an earlier search, then
+ * the shallowest one. With DEPTH_PREFERRED the result is dropped rather than push out a deeper
+ * result of the current search, or a deeper search of the same position; with ALWAYS_REPLACE it
+ * always goes in.
+ *
+ * @param uint64_t key - the Board hash key of the position
+ * @param int depth - how many plies were searched below the position
+ * @param Bound bound - how score relates to the true score
+ * @param int score - the score the search returned
+ * @param Board::PackedMove move - the best move found; a null move keeps the one already stored
+ */
+void TranspositionTable::store(uint64_t key, int depth, Bound bound, int score, Board::PackedMove move)
+{
+    Bucket &bucket = buckets[key & bucketMask];
+    uint32_t keyCheck = (uint32_t)(key >> 32);
+    Entry *replaced = NULL;
+
+    for (int entryIter = 0; entryIter < ENTRIES_PER_BUCKET && replaced == NULL; entryIter++)
+    {
+        if (bucket.entries[entryIter].keyCheck == keyCheck && bucket.entries[entryIter].bound != NO_BOUND)
+            replaced = &bucket.entries[entryIter];
+    }
+
+    if (replaced != NULL)
+    {
+        bool isDeeper = replaced->generation == generation && replaced->depth > depth;
+
+        if (policy == DEPTH_PREFERRED && isDeeper && bound != EXACT)
+            return;
+
+        if (move.isNull())
+            move = replaced->move;
+    }
+    else
+    {
+        // Empty entries count as the oldest and shallowest
+        int replacedWorth = 0;
+
+        for (int entryIter = 0; entryIter < ENTRIES_PER_BUCKET; entryIter++)
+        {
+            const Entry &entry = bucket.entries[entryIter];
+            int worth = (entry.bound == NO_BOUND) ? -1 : entry.depth + (entry.generation == generation ? 128 : 0);
+
+            if (replaced == NULL || worth < replacedWorth)
+            {
+                replaced = &bucket.entries[entryIter];
+                replacedWorth = worth;
+            }
+        }
+
+        if (policy == DEPTH_PREFERRED && replacedWorth >= 128 + depth + 1)
+            return;
+    }
+
+    replaced->keyCheck = keyCheck;
+    replaced->move = move;
+    replaced->score = score;
+    replaced->depth = (int8_t)depth;
+    replaced->bound = (uint8_t)bound;
+    replaced->generation = generation;
+}
+
+/**
+ * newSearch is called once before each search. Entries stored by earlier searches stay usable,
+ * but are the first to make room for new results.
+ */
+void TranspositionTable::newSearch()
+{
+    generation++;
+}
+
+/**
+ * clear empties every entry.
+ */
+void TranspositionTable::clear()
+{
+    for (uint64_t bucketIter = 0; bucketIter <= bucketMask; bucketIter++)
+        buckets[bucketIter] = Bucket();
+}
+
+size_t TranspositionTable::getNumEntries() const
+{
+    return (bucketMask + 1) * ENTRIES_PER_BUCKET;
+}
+
+TranspositionTable::ReplacementPolicy TranspositionTable::getPolicy() const
+{
+    return policy;
+}
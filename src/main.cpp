@@ -7,6 +7,8 @@
 #include "Player.hpp"
 #include "Pieces.hpp"
 #include "Algorithm.hpp"
+#include "Benchmark.hpp"
+#include "Perft.hpp"
 
 /**
  * Main entry way into the application via main() method. 
@@ -25,7 +27,7 @@
 void printWelcomeMsg();
 void printHelpMenu();
 void printMainMenuOptions();
-void executeRunBasedOnUserInput(int userInput, bool &isInputValid);
+void executeRunBasedOnUserInput(int userInput, bool &isInputValid, int timePerMoveMs, bool usePrincipalVariation);
 void getCustomSimUserInput(int &computerPlayerAlg, int &computerPlayerEval, int &depth);
 void getCustomSimUserInput(int &playerOneAlg, int &playerOneEvalFunct, int &playerTwoAlg, int &playerTwoEvalFunct, int &depth);
 void runManualGame();
@@ -55,6 +57,53 @@ int main(int argc, char *argv[])
             return EXIT_SUCCESS;
         }
 
+        if (cliArg == "-bench") // measure the engine, no game is played
+        {
+            Benchmark benchmark;
+            benchmark.runAll();
+            return EXIT_SUCCESS;
+        }
+
+        if (cliArg == "-perft") // count move sequences: -perft [depth] [threads] [-nobulk] [-position text]
+        {
+            int maxDepth = 8;
+            int numThreads = 1;
+            int numNumbersRead = 0;
+            bool bulkCount = true;
+            Board position;
+
+            for (int argIter = 2; argIter < argc; argIter++)
+            {
+                std::string perftArg = argv[argIter];
+
+                if (perftArg == "-nobulk")
+                {
+                    bulkCount = false;
+                }
+                else if (perftArg == "-position" && argIter + 1 < argc)
+                {
+                    argIter++;
+                    if (!Board::parsePosition(argv[argIter], position))
+                    {
+                        std::cerr << "Invalid position: " << argv[argIter] << std::endl;
+                        return EXIT_FAILURE;
+                    }
+                }
+                else if (numNumbersRead++ == 0)
+                {
+                    maxDepth = atoi(argv[argIter]);
+                }
+                else
+                {
+                    numThreads = atoi(argv[argIter]);
+                }
+            }
+
+            Perft perft;
+            perft.run(position, position.getSideToMove(), maxDepth, numThreads > 0 ? numThreads : 1, bulkCount);
+            return EXIT_SUCCESS;
+        }
+
         if (cliArg == "-nc") // disable color
         {
             // ANSII codes for colored text, to improve UI and readability
@@ -88,6 +137,17 @@ int main(int argc, char *argv[])
         }
     }
 
+    // -movetime ms and -pvs may follow any of the options above
+    int timePerMoveMs = 0;
+    bool usePrincipalVariation = false;
+    for (int argIter = 1; argIter < argc; argIter++)
+    {
+        if (strcmp(argv[argIter], "-movetime") == 0 && argIter + 1 < argc)
+            timePerMoveMs = atoi(argv[argIter + 1]);
+        else if (strcmp(argv[argIter], "-pvs") == 0)
+            usePrincipalVariation = true;
+    }
+
     printWelcomeMsg();
     printMainMenuOptions();
 
@@ -98,7 +158,7 @@ int main(int argc, char *argv[])
         std::cout << "Your choice " << Pieces::ANSII_BLUE_START << "(1, 2, 3, or 4)" << Pieces::ANSII_END << ": ";
         std::cin >> userInput;
 
-        executeRunBasedOnUserInput(userInput, isInputValid);
+        executeRunBasedOnUserInput(userInput, isInputValid, timePerMoveMs, usePrincipalVariation);
     }
 
     goodbye();
@@ -128,6 +188,12 @@ void printHelpMenu()
     std::cout << "Additional details for building and execution are also available in the README file." << std::endl;
     std::cout << std::endl;
     std::cout << "Run with -nc for No Color, with -no for No Debug Output, or with -ncno for both No Color AND No Debug Output." << std::endl;
+    std::cout << "Run with -bench to measure the engine instead of playing a game." << std::endl;
+    std::cout << "Add -movetime ms to give each computer move a time budget in milliseconds. The search deepens "
+              << "one ply at a time until it runs out, and the depth entered becomes the deepest search." << std::endl;
+    std::cout << "Add -pvs to have AB Prune players search with Principal Variation Search." << std::endl;
+    std::cout << "Run with -perft [depth] [threads] [-nobulk] [-position text] to count every move sequence from the "
+              << "initial board, or from a position such as B:R1-12:B21-32, to each depth up to depth." << std::endl;
     std::cout << "When executing the program, you will be prompted to enter the algorithm and evaluation "
               << "function for the simulation." << std::endl;
     std::cout << "Please follow the instructions on the screen - if you do not care for any specific custom "
@@ -159,9 +225,11 @@ void printMainMenuOptions()
 /**
  * Given the user's choice in the main menu, execute the program accordingly.
  */
-void executeRunBasedOnUserInput(int userInput, bool &isInputValid)
+void executeRunBasedOnUserInput(int userInput, bool &isInputValid, int timePerMoveMs, bool usePrincipalVariation)
 {
     Simulation *simulation = new Simulation();
+    simulation->setTimePerMove(timePerMoveMs);
+    simulation->setPrincipalVariationSearch(usePrincipalVariation);
     switch (userInput)
     {
     case 1: // full sim
@@ -257,15 +325,15 @@ void runManualGame()
     bool gameOver = false;
     int moveSelection;
     Color currentPlayer = Color::BLACK;
-    std::vector<Board::Move> redMoves;
-    std::vector<Board::Move> blackMoves;
+    Board::MoveList redMoves;
+    Board::MoveList blackMoves;
     Board board;
     board.printBoard();
 
     while (!gameOver)
     {
-        std::vector<Board::Move> redMoves = board.moveGen(Color::RED);
-        std::vector<Board::Move> blackMoves = board.moveGen(Color::BLACK);
+        Board::MoveList redMoves = board.moveGen(Color::RED);
+        Board::MoveList blackMoves = board.moveGen(Color::BLACK);
         std::cout << std::endl;
         std::cout << "Red (r = MAN / R = KING) moves: ";
 